@@ -0,0 +1,154 @@
+#include "AssetManager.hpp"
+#include "GlobalWindow.hpp"
+
+#include <algorithm>
+#include <vector>
+
+/*
+ * Loads textures once per file path, and shares them between everything that requests them.
+ *
+ * \param budget The most video memory loaded textures should use, in bytes. 512MB by default.
+ */
+AssetManager::AssetManager(size_t budget)
+: budget(budget)
+{
+
+}
+
+/* Release all textures */
+AssetManager::~AssetManager()
+{
+    Clear();
+}
+
+/*
+ * Finds the texture loaded from a file. If the file has not been loaded yet, it is loaded 
+ * and kept for future requests.
+ * 
+ * \param path The file to load the texture from.
+ * \returns A pointer to the shared texture. `nullptr` if the file could not be loaded.
+ * 
+ * \warning The texture is shared with everything else that loaded the same file, so colour,
+ * alpha and blend mode changes apply to all of them.
+ */
+std::shared_ptr<LTexture> AssetManager::LoadTexture(std::string path)
+{
+    // already loaded
+    auto it = textures.find(path);
+    if (it != textures.end()) {
+        it->second.last_used = ++requests;
+        return it->second.texture;
+    }
+
+    // decode and upload the file
+    auto texture = std::make_shared<LTexture>(gWindow);
+    if (!texture->loadFromFile(path)) return nullptr;
+    AddTexture(path, texture);
+    return texture;
+}
+
+/*
+ * Adds an already loaded texture to the manager, so future requests for the path share it.
+ * Replaces any texture already stored for the path.
+ */
+void AssetManager::AddTexture(std::string path, std::shared_ptr<LTexture> texture)
+{
+    if (texture == nullptr) return;
+
+    TextureAsset asset;
+    asset.texture = texture;
+    asset.bytes = (size_t)texture->getWidth() * (size_t)texture->getHeight() * 4;
+    asset.last_used = ++requests;
+
+    // replace existing asset
+    auto it = textures.find(path);
+    if (it != textures.end()) {
+        bytes -= it->second.bytes;
+        it->second = asset;
+    } else textures.emplace(path, asset);
+    bytes += asset.bytes;
+
+    evict();
+}
+
+/* Whether a texture has been loaded for the given path. */
+bool AssetManager::HasTexture(std::string path) const
+{
+    return textures.find(path) != textures.end();
+}
+
+/*
+ * Unloads the least recently used textures that are not used outside the manager,
+ * until memory use is within budget, or no such textures remain.
+ */
+void AssetManager::evict()
+{
+    if (bytes <= budget) return;
+
+    // find all textures only referenced by the manager
+    std::vector<std::unordered_map<std::string,TextureAsset>::iterator> unused;
+    for (auto it = textures.begin(); it != textures.end(); it++) {
+        if (it->second.texture.use_count() == 1) unused.push_back(it);
+    }
+    // unload the least recently used first
+    std::sort(unused.begin(), unused.end(), [](auto& a, auto& b) {
+        return a->second.last_used < b->second.last_used;
+    });
+    for (auto& it : unused) {
+        if (bytes <= budget) break;
+        bytes -= it->second.bytes;
+        textures.erase(it);
+    }
+}
+
+/* Unloads every texture that is not used outside the manager, regardless of the budget. */
+void AssetManager::UnloadUnused()
+{
+    for (auto it = textures.begin(); it != textures.end();) {
+        if (it->second.texture.use_count() == 1) {
+            bytes -= it->second.bytes;
+            it = textures.erase(it);
+        } else it++;
+    }
+}
+
+/* Releases all textures. Textures still used elsewhere stay loaded until they are no longer used. */
+void AssetManager::Clear()
+{
+    textures.clear();
+    bytes = 0;
+}
+
+/* Set the most video memory loaded textures should use, in bytes. Unloads unused textures if over budget. */
+void AssetManager::SetBudget(size_t newBudget)
+{
+    budget = newBudget;
+    evict();
+}
+
+/* The most video memory loaded textures should use, in bytes. */
+size_t AssetManager::Budget() const { return budget; }
+/* Estimated video memory used by all loaded textures, in bytes. */
+size_t AssetManager::MemoryUsage() const { return bytes; }
+/* The number of loaded textures. */
+size_t AssetManager::TextureCount() const { return textures.size(); }
+
+/* Estimated video memory used by the texture loaded from the given path, in bytes. `0` if not loaded. */
+size_t AssetManager::TextureMemory(std::string path) const
+{
+    auto it = textures.find(path);
+    return (it==textures.end())? 0 : it->second.bytes;
+}
+
+// create global asset manager
+AssetManager assetManager = AssetManager();
+
+/*
+ * Finds the texture loaded from a file, loading it if it has not been loaded yet.
+ * Every request for the same path shares one texture.
+ * 
+ * \returns A pointer to the shared texture. `nullptr` if the file could not be loaded.
+ */
+std::shared_ptr<LTexture> LoadTexture(std::string path) {
+    return assetManager.LoadTexture(path);
+}
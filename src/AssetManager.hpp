@@ -0,0 +1,64 @@
+#pragma once
+
+#include "sdl/LTexture.hpp"
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/* A texture held by the asset manager */
+struct TextureAsset
+{
+    /* The loaded texture */
+    std::shared_ptr<LTexture> texture;
+    /* Estimated video memory used by the texture, in bytes */
+    size_t bytes = 0;
+    /* When the texture was last requested, used to evict the least recently used textures first */
+    unsigned long last_used = 0;
+};
+
+/* 
+ * Loads textures once per file path, and shares them between everything that requests them.
+ * Textures no longer used anywhere else are unloaded when the memory budget is exceeded.
+ */
+class AssetManager
+{
+    public:
+
+        AssetManager(size_t budget = 512*1024*1024);
+        ~AssetManager();
+
+        std::shared_ptr<LTexture> LoadTexture(std::string path);
+        void AddTexture(std::string path, std::shared_ptr<LTexture> texture);
+        bool HasTexture(std::string path) const;
+
+        void UnloadUnused();
+        void Clear();
+
+        void SetBudget(size_t bytes);
+        size_t Budget() const;
+
+        size_t MemoryUsage() const;
+        size_t TextureMemory(std::string path) const;
+        size_t TextureCount() const;
+
+    private:
+
+        /* All loaded textures, by file path */
+        std::unordered_map<std::string,TextureAsset> textures;
+
+        /* The most video memory loaded textures should use, in bytes */
+        size_t budget;
+        /* Estimated video memory used by all loaded textures, in bytes */
+        size_t bytes = 0;
+
+        /* Counts texture requests, to track when each texture was last used */
+        unsigned long requests = 0;
+
+        void evict();
+};
+
+/* Global asset manager */
+extern AssetManager assetManager;
+
+std::shared_ptr<LTexture> LoadTexture(std::string path);
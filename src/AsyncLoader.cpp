@@ -0,0 +1,197 @@
+#include "AsyncLoader.hpp"
+#include "AssetManager.hpp"
+#include "GlobalWindow.hpp"
+
+/* The most worker threads the loader will start */
+#define MAX_LOADER_THREADS 4
+
+/*
+ * Loads textures and audio on worker threads. Workers are started on the first request.
+ *
+ * \param uploadBudget The most texture data to upload each frame, in bytes. 8MB by default.
+ * At least one finished load is applied each frame, even if it is larger than the budget.
+ */
+AsyncLoader::AsyncLoader(size_t uploadBudget)
+: upload_budget(uploadBudget)
+{
+
+}
+
+/* Stops all workers, and frees anything decoded but not yet applied. */
+AsyncLoader::~AsyncLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+    workers.clear();
+
+    for (auto& job : results) {
+        if (job.surface != NULL) SDL_FreeSurface(job.surface);
+        if (job.chunk != NULL) Mix_FreeChunk(job.chunk);
+    }
+    results.clear();
+    jobs.clear();
+}
+
+/*
+ * Starts loading a texture in the background. If the texture is already loaded by the
+ * asset manager, the returned handle is ready immediately. Once loaded, the texture is
+ * added to the asset manager, so `LoadTexture` will share it.
+ * 
+ * \param path The file to load the texture from.
+ * \returns A handle to the loading texture.
+ */
+std::shared_ptr<AsyncAsset<LTexture>> AsyncLoader::LoadTexture(std::string path)
+{
+    // already loaded
+    if (assetManager.HasTexture(path)) {
+        auto handle = std::make_shared<AsyncAsset<LTexture>>(assetManager.LoadTexture(path), path);
+        handle->status = Loaded;
+        return handle;
+    }
+    // already loading
+    auto it = loading.find(path);
+    if (it != loading.end()) return it->second;
+
+    // textures must be created on the main thread, only decoding is done by workers
+    auto handle = std::make_shared<AsyncAsset<LTexture>>(std::make_shared<LTexture>(gWindow), path);
+    loading.emplace(path, handle);
+    Job job;
+    job.texture = handle;
+    queue(job);
+    return handle;
+}
+
+/*
+ * Starts loading audio in the background.
+ * 
+ * \param path The file to load the audio from.
+ * \returns A handle to the loading audio.
+ */
+std::shared_ptr<AsyncAsset<LAudio>> AsyncLoader::LoadAudio(std::string path)
+{
+    // creating the audio object opens the audio device, which decoding requires
+    auto handle = std::make_shared<AsyncAsset<LAudio>>(std::make_shared<LAudio>(), path);
+    Job job;
+    job.audio = handle;
+    queue(job);
+    return handle;
+}
+
+/* Adds a job for the workers, starting them if they haven't been yet. */
+void AsyncLoader::queue(Job job)
+{
+    if (workers.empty()) {
+        unsigned int n = std::thread::hardware_concurrency();
+        n = (n>1)? Math::min(n-1, (unsigned int)MAX_LOADER_THREADS) : 1;
+        for (unsigned int i=0; i<n; i++) workers.emplace_back(&AsyncLoader::work, this);
+    }
+
+    pending++;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    wake.notify_one();
+}
+
+/* Worker thread loop. Decodes files until the loader is destroyed. */
+void AsyncLoader::work()
+{
+    while (true)
+    {
+        Job job;
+        {
+            // wait for a job
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this]{ return stop || !jobs.empty(); });
+            if (stop) return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+
+        // decode without touching the renderer
+        if (job.texture != nullptr) job.surface = LTexture::loadSurface(job.texture->path);
+        else job.chunk = LAudio::loadChunk(job.audio->path);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        results.push_back(job);
+    }
+}
+
+/*
+ * Applies decoded files to their handles, uploading textures until this frame's upload
+ * budget is used up. Anything left over is applied on following frames.
+ * 
+ * \note Called once per frame by the game. Must only be called from the main thread.
+ */
+void AsyncLoader::Update()
+{
+    if (pending == 0) return;
+
+    size_t uploaded = 0;
+    while (true)
+    {
+        Job job;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (results.empty()) break;
+            // stop once the budget is used, but always apply at least one result
+            size_t size = (results.front().surface==NULL)? 0 : 
+                (size_t)results.front().surface->w * (size_t)results.front().surface->h * 4;
+            if (uploaded > 0 && uploaded + size > upload_budget) break;
+            uploaded += size;
+            job = results.front();
+            results.pop_front();
+        }
+        apply(job);
+    }
+}
+
+/* Uploads or stores a decoded file in its handle's asset, and marks the handle as done. */
+void AsyncLoader::apply(Job& job)
+{
+    pending--;
+    if (job.texture != nullptr)
+    {
+        auto& handle = job.texture;
+        loading.erase(handle->path);
+        if (job.surface != NULL && handle->asset->loadFromSurface(job.surface)) {
+            handle->status = Loaded;
+            assetManager.AddTexture(handle->path, handle->asset);
+        } else handle->status = LoadFailed;
+        if (job.surface != NULL) SDL_FreeSurface(job.surface);
+    }
+    else
+    {
+        auto& handle = job.audio;
+        // the audio object takes ownership of the chunk
+        handle->status = handle->asset->loadFromChunk(job.chunk)? Loaded : LoadFailed;
+    }
+}
+
+/* Set the most texture data to upload each frame, in bytes. */
+void AsyncLoader::SetUploadBudget(size_t bytes) { upload_budget = bytes; }
+/* The most texture data to upload each frame, in bytes. */
+size_t AsyncLoader::UploadBudget() const { return upload_budget; }
+/* Number of requested assets that have not finished loading. */
+size_t AsyncLoader::Pending() const { return pending; }
+
+// create global loader
+AsyncLoader asyncLoader = AsyncLoader();
+
+/*
+ * Starts loading a texture in the background. Check the returned handle's `Ready()` 
+ * before using it. Textures already loaded are shared, and ready immediately.
+ */
+std::shared_ptr<AsyncAsset<LTexture>> LoadTextureAsync(std::string path) {
+    return asyncLoader.LoadTexture(path);
+}
+
+/* Starts loading audio in the background. Check the returned handle's `Ready()` before using it. */
+std::shared_ptr<AsyncAsset<LAudio>> LoadAudioAsync(std::string path) {
+    return asyncLoader.LoadAudio(path);
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "sdl/LTexture.hpp"
+#include "sdl/LAudio.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* The state of an asynchronously loaded asset */
+enum LoadStatus
+{
+    Loading,
+    Loaded,
+    LoadFailed,
+};
+
+/*
+ * Handle to an asset being loaded in the background. Check `Ready()` before using `Get()`.
+ * Handles are only ever updated on the main thread, during `AsyncLoader::Update`.
+ */
+template <typename T>
+class AsyncAsset
+{
+    public:
+
+        AsyncAsset(std::shared_ptr<T> asset, std::string path)
+        : asset(asset), path(path)
+        {
+
+        }
+
+        /* Whether the asset has finished loading successfully. */
+        bool Ready() const { return status == Loaded; }
+        /* Whether the asset could not be loaded. */
+        bool Failed() const { return status == LoadFailed; }
+        /* Whether loading has finished, successfully or not. */
+        bool Done() const { return status != Loading; }
+        /* The current loading state. */
+        LoadStatus Status() const { return status; }
+        /* The file the asset is loaded from. */
+        std::string Path() const { return path; }
+
+        /* The loaded asset. `nullptr` until the asset is ready. */
+        std::shared_ptr<T> Get() const { return (status==Loaded)? asset : nullptr; }
+
+    private:
+
+        friend class AsyncLoader;
+
+        /* The asset being loaded into */
+        std::shared_ptr<T> asset;
+        /* The file the asset is loaded from */
+        std::string path;
+        /* The current loading state */
+        LoadStatus status = Loading;
+};
+
+/*
+ * Loads textures and audio on worker threads. Files are decoded in the background, and the 
+ * results are applied on the main thread during `Update`, with a limit on how much texture
+ * data is uploaded each frame so that loading doesn't cause frame drops.
+ */
+class AsyncLoader
+{
+    public:
+
+        AsyncLoader(size_t uploadBudget = 8*1024*1024);
+        ~AsyncLoader();
+
+        std::shared_ptr<AsyncAsset<LTexture>> LoadTexture(std::string path);
+        std::shared_ptr<AsyncAsset<LAudio>> LoadAudio(std::string path);
+
+        void Update();
+
+        void SetUploadBudget(size_t bytes);
+        size_t UploadBudget() const;
+
+        size_t Pending() const;
+
+    private:
+
+        /* A file to decode, and the handle to apply it to */
+        struct Job
+        {
+            std::shared_ptr<AsyncAsset<LTexture>> texture;
+            std::shared_ptr<AsyncAsset<LAudio>> audio;
+            /* Decoded results, filled in by a worker */
+            SDL_Surface *surface = NULL;
+            Mix_Chunk *chunk = NULL;
+        };
+
+        /* Files waiting to be decoded */
+        std::deque<Job> jobs;
+        /* Decoded files waiting to be applied on the main thread */
+        std::deque<Job> results;
+        /* Guards `jobs`, `results` and `stop` */
+        mutable std::mutex mutex;
+        /* Wakes workers when jobs are added */
+        std::condition_variable wake;
+        /* Tells workers to exit */
+        bool stop = false;
+
+        std::vector<std::thread> workers;
+
+        /* Textures currently loading, so repeated requests share one handle */
+        std::unordered_map<std::string,std::shared_ptr<AsyncAsset<LTexture>>> loading;
+
+        /* The most texture data to upload each frame, in bytes */
+        size_t upload_budget;
+        /* Number of requests not yet applied */
+        size_t pending = 0;
+
+        void queue(Job job);
+        void work();
+        void apply(Job& job);
+};
+
+/* Global asynchronous loader */
+extern AsyncLoader asyncLoader;
+
+std::shared_ptr<AsyncAsset<LTexture>> LoadTextureAsync(std::string path);
+std::shared_ptr<AsyncAsset<LAudio>> LoadAudioAsync(std::string path);
@@ -6,10 +6,14 @@
 #include "sdl/LTexture.hpp"
 #include "sdl/LAudio.hpp"
 #include "sdl/LFont.hpp"
+#include "sdl/LGlyphAtlas.hpp"
+#include "sdl/LTextCache.hpp"
 
 #include "GlobalWindow.hpp"
 #include "InputHandler.hpp"
 #include "TimeTracker.hpp"
+#include "AssetManager.hpp"
+#include "AsyncLoader.hpp"
 
 #include "GameObject/GameObject.hpp"
 #include "GameObject/ObjectComponent.hpp"
@@ -17,10 +21,16 @@
 #include "GameObject/Cameras/Camera.hpp"
 
 #include "GameObject/Renderer/RenderManager.hpp"
+#include "GameObject/Renderer/Sprite.hpp"
 #include "GameObject/Renderer/TextureRenderer.hpp"
+#include "GameObject/Renderer/AnimationClip.hpp"
 #include "GameObject/Renderer/AnimationRenderer.hpp"
+#include "GameObject/Renderer/ParticleEmitter.hpp"
 #include "GameObject/Renderer/TextRenderer.hpp"
 
+#include "GameObject/Tilemap/Tilemap.hpp"
+#include "GameObject/Tilemap/TilemapCollider.hpp"
+
 #include "GameObject/Colliders/ColliderManager.hpp"
 #include "GameObject/Colliders/BoxCollider.hpp"
 
@@ -32,6 +42,10 @@
 
 #include "GameObject/Audio/AudioPlayer.hpp"
 
+#include "ECS/EntityWorld.hpp"
+#include "ECS/Components.hpp"
+#include "ECS/Systems.hpp"
+
 #include "GameObject/Templates/GenericTrigger.hpp"
 
 /// @brief  declaration for user initialiser function
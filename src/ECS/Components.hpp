@@ -0,0 +1,39 @@
+#pragma once
+
+#include "../Math/VectorMath.hpp"
+#include "../GameObject/Renderer/Sprite.hpp"
+
+using namespace Math;
+
+/* ECS equivalents of game object components, stored by value in entity worlds */
+
+/* Position and size of an entity, like a game object's transform */
+struct TransformData {
+    Vector2 position;
+    Vector2 scale = {1.0f, 1.0f};
+};
+
+/* Motion of an entity. Mirrors the fields of `Rigidbody`. */
+struct RigidbodyData {
+    Vector2 velocity;
+    Vector2 acceleration;
+    float mass = 1.0f;
+    float friction = 0.0f;
+    bool moveable = true;
+    bool gravity = true;
+};
+
+/* Box centred on an entity's transform. Mirrors the bounding box of `BoxCollider`. */
+struct BoxColliderData {
+    RectF box;
+};
+
+/*
+ * A sprite in the render manager, centred on and sized to an entity's transform.
+ * Takes the place of `TextureRenderer`. The sprite is removed with the component.
+ */
+struct SpriteData {
+    SpriteHandle sprite;
+
+    static void OnRemove(SpriteData& data);
+};
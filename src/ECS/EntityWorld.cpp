@@ -0,0 +1,203 @@
+#include "EntityWorld.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+EntityWorld ecsWorld;
+
+/* The storage information of a registered component type */
+ComponentInfo& GetComponentInfo(int id)
+{
+    static ComponentInfo infos[ECS_MAX_COMPONENTS];
+    return infos[id];
+}
+
+/* Assigns the next component id to a component type. Use `ComponentId<T>()` instead. */
+int RegisterComponent(ComponentInfo info)
+{
+    static int next = 0;
+    if (next >= ECS_MAX_COMPONENTS) {
+        printf("Too many ECS component types! The maximum is %d.\n", ECS_MAX_COMPONENTS);
+        exit(1);
+    }
+    GetComponentInfo(next) = info;
+    return next++;
+}
+
+/* Creates an empty world, with an archetype for entities without components */
+EntityWorld::EntityWorld()
+{
+    get_archetype(0);
+}
+
+/* Creates an entity without any components */
+Entity EntityWorld::CreateEntity()
+{
+    Entity entity;
+    if (!free_records.empty()) {
+        entity.index = free_records.back();
+        free_records.pop_back();
+    }
+    else {
+        entity.index = records.size();
+        records.emplace_back();
+    }
+    entity.generation = records[entity.index].generation;
+
+    allocate_row(0, entity);
+    entity_count++;
+    return entity;
+}
+
+/* Destroys an entity and all of its components */
+void EntityWorld::DestroyEntity(Entity entity)
+{
+    if (!Alive(entity)) return;
+    EntityRecord& record = records[entity.index];
+
+    for (int id : archetypes[record.archetype].components) {
+        if (GetComponentInfo(id).on_remove != nullptr) GetComponentInfo(id).on_remove(component_data(record, id));
+    }
+    remove_row(record.archetype, record.chunk, record.row);
+
+    record.archetype = -1;
+    record.generation++;
+    free_records.push_back(entity.index);
+    entity_count--;
+}
+
+/* Whether an entity is still stored in the world */
+bool EntityWorld::Alive(Entity entity) const
+{
+    if (entity.index >= records.size()) return false;
+    const EntityRecord& record = records[entity.index];
+    return record.archetype != -1 && record.generation == entity.generation;
+}
+
+/* Destroys all entities */
+void EntityWorld::Clear()
+{
+    for (auto& archetype : archetypes) {
+        for (int id : archetype.components) {
+            auto on_remove = GetComponentInfo(id).on_remove;
+            if (on_remove == nullptr) continue;
+
+            std::size_t size = GetComponentInfo(id).size;
+            int column = archetype.column[id];
+            for (auto& chunk : archetype.chunks) {
+                for (int i = 0; i < chunk.count; i++) on_remove(chunk.columns[column].data() + i*size);
+            }
+        }
+        archetype.chunks.clear();
+    }
+
+    // invalidate every entity, keeping generations so old entities stay stale
+    free_records.clear();
+    for (unsigned int i = 0; i < records.size(); i++) {
+        if (records[i].archetype != -1) records[i].generation++;
+        records[i].archetype = -1;
+        free_records.push_back(i);
+    }
+    entity_count = 0;
+}
+
+int EntityWorld::EntityCount() const { return entity_count; }
+int EntityWorld::ArchetypeCount() const { return archetypes.size(); }
+
+
+/* ==========  HELPER FUNCTIONS  ========== */
+
+/* Gets the index of the archetype with the given mask, creating it if it doesn't exist */
+int EntityWorld::get_archetype(ComponentMask mask)
+{
+    auto it = archetype_lookup.find(mask);
+    if (it != archetype_lookup.end()) return it->second;
+
+    Archetype archetype;
+    archetype.mask = mask;
+    for (int id = 0; id < ECS_MAX_COMPONENTS; id++) {
+        archetype.column[id] = -1;
+        if (mask & (ComponentMask(1) << id)) {
+            archetype.column[id] = archetype.components.size();
+            archetype.components.push_back(id);
+        }
+    }
+    archetypes.push_back(std::move(archetype));
+    archetype_lookup[mask] = archetypes.size()-1;
+    return archetypes.size()-1;
+}
+
+/* Adds a row for an entity at the end of an archetype, and points the entity's record at it */
+void EntityWorld::allocate_row(int archetype, Entity entity)
+{
+    Archetype& arch = archetypes[archetype];
+    if (arch.chunks.empty() || arch.chunks.back().count == ECS_CHUNK_SIZE) {
+        ArchetypeChunk chunk;
+        chunk.entities.resize(ECS_CHUNK_SIZE);
+        for (int id : arch.components) chunk.columns.emplace_back(ECS_CHUNK_SIZE * GetComponentInfo(id).size);
+        arch.chunks.push_back(std::move(chunk));
+    }
+
+    ArchetypeChunk& chunk = arch.chunks.back();
+    chunk.entities[chunk.count] = entity;
+
+    EntityRecord& record = records[entity.index];
+    record.archetype = archetype;
+    record.chunk = arch.chunks.size()-1;
+    record.row = chunk.count++;
+}
+
+/*
+ * Removes a row from an archetype without cleaning up its components.
+ * The archetype's last row is moved into the gap, so chunks stay packed.
+ */
+void EntityWorld::remove_row(int archetype, int chunk, int row)
+{
+    Archetype& arch = archetypes[archetype];
+    ArchetypeChunk& last = arch.chunks.back();
+    int last_row = last.count-1;
+
+    if (&arch.chunks[chunk] != &last || row != last_row) {
+        ArchetypeChunk& target = arch.chunks[chunk];
+        for (unsigned int c = 0; c < arch.components.size(); c++) {
+            std::size_t size = GetComponentInfo(arch.components[c]).size;
+            std::memcpy(target.columns[c].data() + row*size, last.columns[c].data() + last_row*size, size);
+        }
+        Entity moved = last.entities[last_row];
+        target.entities[row] = moved;
+        records[moved.index].chunk = chunk;
+        records[moved.index].row = row;
+    }
+
+    if (--last.count == 0) arch.chunks.pop_back();
+}
+
+/*
+ * Moves an entity to the archetype with the given mask, copying the components both archetypes share.
+ * Components not in the new archetype are cleaned up. New components are left uninitialised.
+ */
+void EntityWorld::move_entity(Entity entity, ComponentMask mask)
+{
+    EntityRecord old_record = records[entity.index];
+    int target = get_archetype(mask);
+    if (target == old_record.archetype) return;
+
+    allocate_row(target, entity);
+    const EntityRecord& new_record = records[entity.index];
+
+    for (int id : archetypes[old_record.archetype].components) {
+        void *data = component_data(old_record, id);
+        if (mask & (ComponentMask(1) << id)) std::memcpy(component_data(new_record, id), data, GetComponentInfo(id).size);
+        else if (GetComponentInfo(id).on_remove != nullptr) GetComponentInfo(id).on_remove(data);
+    }
+
+    remove_row(old_record.archetype, old_record.chunk, old_record.row);
+}
+
+/* The memory of a component stored at a record's location */
+void *EntityWorld::component_data(const EntityRecord& record, int id)
+{
+    const Archetype& arch = archetypes[record.archetype];
+    int column = arch.column[id];
+    return (void*)(arch.chunks[record.chunk].columns[column].data() + record.row*GetComponentInfo(id).size);
+}
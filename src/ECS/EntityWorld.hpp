@@ -0,0 +1,276 @@
+#pragma once
+
+#include "../JobSystem.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/* The most component types that can be used with entity worlds */
+#define ECS_MAX_COMPONENTS 64
+/* Number of entities stored in each archetype chunk */
+#define ECS_CHUNK_SIZE 1024
+
+/* Bitset with one bit per component type */
+typedef std::uint64_t ComponentMask;
+
+/* Identifies an entity stored in an entity world */
+struct Entity {
+    /* The entity's slot in the world. `0xFFFFFFFF` for no entity. */
+    unsigned int index = 0xFFFFFFFF;
+    /* The generation of the slot when the entity was created. Stale entities don't match. */
+    unsigned int generation = 0;
+
+    bool operator==(const Entity& other) const { return index==other.index && generation==other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this==other); }
+};
+
+/* How an entity world stores and cleans up a component type */
+struct ComponentInfo {
+    /* Size of the component in bytes */
+    std::size_t size = 0;
+    /* Called with a component's memory before it is removed. `nullptr` for no clean up. */
+    void (*on_remove)(void*) = nullptr;
+};
+
+ComponentInfo& GetComponentInfo(int id);
+int RegisterComponent(ComponentInfo info);
+
+// detects a `static void OnRemove(T&)` member on component types
+template <typename T, typename = void>
+struct has_on_remove : std::false_type {};
+template <typename T>
+struct has_on_remove<T, std::void_t<decltype(T::OnRemove(std::declval<T&>()))>> : std::true_type {};
+
+/*
+ * The component id of type `T`, used as its bit in component masks.
+ *
+ * Components must be trivially copyable, as they are moved between chunks with `memcpy`.
+ * A component can clean up anything it refers to by declaring `static void OnRemove(T&)`,
+ * which is called when it is removed from an entity, or its entity is destroyed.
+ */
+template <typename T>
+int ComponentId()
+{
+    static_assert(std::is_trivially_copyable<T>::value, "ECS components must be trivially copyable");
+    static const int id = [](){
+        ComponentInfo info;
+        info.size = sizeof(T);
+        if constexpr (has_on_remove<T>::value) info.on_remove = [](void *data) { T::OnRemove(*static_cast<T*>(data)); };
+        return RegisterComponent(info);
+    }();
+    return id;
+}
+
+/* The mask with the bits of all given component types set */
+template <typename... Cs>
+ComponentMask MaskOf()
+{
+    ComponentMask mask = 0;
+    ((mask |= ComponentMask(1) << ComponentId<Cs>()), ...);
+    return mask;
+}
+
+/* Fixed size block of entities of one archetype, with one contiguous array per component */
+struct ArchetypeChunk {
+    /* One array per component, in the archetype's component order */
+    std::vector<std::vector<unsigned char>> columns;
+    /* The entity stored in each row */
+    std::vector<Entity> entities;
+    /* Number of rows in use */
+    int count = 0;
+};
+
+/* All entities with exactly the same set of components */
+struct Archetype {
+    ComponentMask mask = 0;
+    /* Component ids in ascending order */
+    std::vector<int> components;
+    /* Index into `components` for each component id, or `-1` if the archetype doesn't have it */
+    int column[ECS_MAX_COMPONENTS];
+    /* Chunks are kept full except for the last one */
+    std::vector<ArchetypeChunk> chunks;
+};
+
+/*
+ * Stores plain data entities grouped by archetype, as an alternative to game objects for
+ * large numbers of similar entities. Systems iterate over every entity with a set of components,
+ * reading each component from a contiguous array.
+ *
+ * Entities must not be created, destroyed, or have components added or removed while iterating.
+ */
+class EntityWorld
+{
+    public:
+
+        EntityWorld();
+
+        Entity CreateEntity();
+        template <typename... Cs>
+        Entity CreateEntity(const Cs&... components);
+        void DestroyEntity(Entity entity);
+        bool Alive(Entity entity) const;
+        void Clear();
+
+        int EntityCount() const;
+        int ArchetypeCount() const;
+
+        template <typename T>
+        void AddComponent(Entity entity, const T& component);
+        template <typename T>
+        void RemoveComponent(Entity entity);
+        template <typename T>
+        T *GetComponent(Entity entity);
+        template <typename T>
+        bool HasComponent(Entity entity) const;
+
+        template <typename... Cs, typename F>
+        void EachChunk(F&& fn);
+        template <typename... Cs, typename F>
+        void Each(F&& fn);
+        template <typename... Cs, typename F>
+        void ParallelEachChunk(F&& fn);
+
+    private:
+
+        /* Where an entity's components are stored */
+        struct EntityRecord {
+            int archetype = -1;
+            int chunk = 0;
+            int row = 0;
+            unsigned int generation = 0;
+        };
+
+        std::vector<EntityRecord> records;
+        /* Indices of record slots not holding an entity */
+        std::vector<unsigned int> free_records;
+        int entity_count = 0;
+
+        std::vector<Archetype> archetypes;
+        std::unordered_map<ComponentMask,int> archetype_lookup;
+
+        /* ==========  HELPER FUNCTIONS  ========== */
+
+        int get_archetype(ComponentMask mask);
+        void allocate_row(int archetype, Entity entity);
+        void remove_row(int archetype, int chunk, int row);
+        void move_entity(Entity entity, ComponentMask mask);
+        void *component_data(const EntityRecord& record, int id);
+};
+
+extern EntityWorld ecsWorld;
+
+
+/* ==========  TEMPLATE FUNCTIONS  ========== */
+
+/* Creates an entity with the given components */
+template <typename... Cs>
+Entity EntityWorld::CreateEntity(const Cs&... components)
+{
+    Entity entity = CreateEntity();
+    if constexpr (sizeof...(Cs) > 0) {
+        move_entity(entity, MaskOf<Cs...>());
+        const EntityRecord& record = records[entity.index];
+        ((std::memcpy(component_data(record, ComponentId<Cs>()), &components, sizeof(Cs))), ...);
+    }
+    return entity;
+}
+
+/* Adds a component to an entity, or overwrites it if the entity already has one. */
+template <typename T>
+void EntityWorld::AddComponent(Entity entity, const T& component)
+{
+    if (!Alive(entity)) return;
+    int id = ComponentId<T>();
+    ComponentMask mask = archetypes[records[entity.index].archetype].mask;
+    if ((mask & (ComponentMask(1) << id)) == 0) move_entity(entity, mask | (ComponentMask(1) << id));
+    std::memcpy(component_data(records[entity.index], id), &component, sizeof(T));
+}
+
+/* Removes a component from an entity, if it has one */
+template <typename T>
+void EntityWorld::RemoveComponent(Entity entity)
+{
+    if (!HasComponent<T>(entity)) return;
+    ComponentMask mask = archetypes[records[entity.index].archetype].mask;
+    move_entity(entity, mask & ~(ComponentMask(1) << ComponentId<T>()));
+}
+
+/*
+ * Gets a component of an entity.
+ *
+ * \returns A pointer to the component, which is invalidated when any entity's components change.
+ * `nullptr` if the entity doesn't have the component.
+ */
+template <typename T>
+T *EntityWorld::GetComponent(Entity entity)
+{
+    if (!HasComponent<T>(entity)) return nullptr;
+    return static_cast<T*>(component_data(records[entity.index], ComponentId<T>()));
+}
+
+template <typename T>
+bool EntityWorld::HasComponent(Entity entity) const
+{
+    if (!Alive(entity)) return false;
+    return (archetypes[records[entity.index].archetype].mask & (ComponentMask(1) << ComponentId<T>())) != 0;
+}
+
+/*
+ * Calls a function once per chunk containing entities with all of the given components.
+ *
+ * \param fn Called as `fn(int count, const Entity *entities, Cs *components...)`,
+ * with one array of `count` elements for each component type.
+ */
+template <typename... Cs, typename F>
+void EntityWorld::EachChunk(F&& fn)
+{
+    ComponentMask required = MaskOf<Cs...>();
+    for (auto& archetype : archetypes) {
+        if ((archetype.mask & required) != required) continue;
+        for (auto& chunk : archetype.chunks) {
+            fn(chunk.count, chunk.entities.data(), reinterpret_cast<Cs*>(chunk.columns[archetype.column[ComponentId<Cs>()]].data())...);
+        }
+    }
+}
+
+/*
+ * Calls a function for each entity with all of the given components.
+ *
+ * \param fn Called as `fn(Entity entity, Cs& components...)`.
+ */
+template <typename... Cs, typename F>
+void EntityWorld::Each(F&& fn)
+{
+    EachChunk<Cs...>([&fn](int count, const Entity *entities, Cs*... components) {
+        for (int i = 0; i < count; i++) fn(entities[i], components[i]...);
+    });
+}
+
+/*
+ * Like `EachChunk`, but chunks are spread across the job system's threads.
+ * The world must not be changed until it returns.
+ *
+ * \param fn Called as `fn(int count, const Entity *entities, Cs *components...)`.
+ * Must only change the components of the chunk it is given.
+ */
+template <typename... Cs, typename F>
+void EntityWorld::ParallelEachChunk(F&& fn)
+{
+    ComponentMask required = MaskOf<Cs...>();
+    std::vector<std::pair<Archetype*,ArchetypeChunk*>> chunks;
+    for (auto& archetype : archetypes) {
+        if ((archetype.mask & required) != required) continue;
+        for (auto& chunk : archetype.chunks) chunks.push_back({&archetype, &chunk});
+    }
+
+    jobSystem.ParallelFor(chunks.size(), 1, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Archetype& archetype = *chunks[i].first;
+            ArchetypeChunk& chunk = *chunks[i].second;
+            fn(chunk.count, chunk.entities.data(), reinterpret_cast<Cs*>(chunk.columns[archetype.column[ComponentId<Cs>()]].data())...);
+        }
+    });
+}
@@ -0,0 +1,117 @@
+#include "Systems.hpp"
+
+#include "../GameObject/GameObject.hpp"
+#include "../GameObject/Rigidbody/Rigidbody.hpp"
+#include "../GameObject/Rigidbody/PhysicsConstants.hpp"
+#include "../GameObject/Colliders/BoxCollider.hpp"
+#include "../GameObject/Renderer/TextureRenderer.hpp"
+#include "../GameObject/Renderer/RenderManager.hpp"
+
+/* Removes the component's sprite from the render manager */
+void SpriteData::OnRemove(SpriteData& data)
+{
+    renderManager.RemoveSprite(data.sprite);
+}
+
+/*
+ * Moves entities by their velocity, then accelerates them, in the same order as `Rigidbody`.
+ * Entities don't collide with each other or with game objects. Chunks are integrated in parallel.
+ */
+void IntegrateRigidbodies(EntityWorld& world, float dt)
+{
+    Vector2 gravity = physicsConstants.gravity;
+    world.ParallelEachChunk<TransformData,RigidbodyData>([dt, gravity](int count, const Entity *entities, TransformData *transforms, RigidbodyData *bodies) {
+        for (int i = 0; i < count; i++) {
+            transforms[i].position += bodies[i].velocity * dt;
+            Vector2 accel = (bodies[i].gravity)? bodies[i].acceleration+gravity : bodies[i].acceleration;
+            bodies[i].velocity += accel * dt;
+        }
+    });
+}
+
+/* Centres each entity's box on its transform. Chunks are updated in parallel. */
+void UpdateBoxColliders(EntityWorld& world)
+{
+    world.ParallelEachChunk<TransformData,BoxColliderData>([](int count, const Entity *entities, TransformData *transforms, BoxColliderData *colliders) {
+        for (int i = 0; i < count; i++) {
+            Vector2 s = transforms[i].scale, origin = transforms[i].position - (s/2.0f);
+            colliders[i].box = {origin.x, origin.y, s.x, s.y};
+        }
+    });
+}
+
+/* Moves each entity's sprite to its transform, if it has changed. Runs on one thread, since it changes the render manager. */
+void SyncSprites(EntityWorld& world)
+{
+    world.Each<TransformData,SpriteData>([](Entity entity, TransformData& transform, SpriteData& data) {
+        const Sprite *sprite = renderManager.GetSprite(data.sprite);
+        if (sprite == nullptr) return;
+
+        Vector2 s = transform.scale, origin = transform.position - (s/2.0f);
+        const RectF& r = sprite->rect;
+        if (r.x==origin.x && r.y==origin.y && r.w==s.x && r.h==s.y) return;
+        renderManager.SetSpriteRect(data.sprite, {origin.x, origin.y, s.x, s.y});
+    });
+}
+
+/*
+ * Runs all built in systems on a world. Called by the game every frame for `ecsWorld`.
+ * Colliders and sprites both wait for integration, then run at the same time.
+ */
+void RunSystems(EntityWorld& world, float dt)
+{
+    if (world.EntityCount() == 0) return;
+    jobSystem.RunPhase({
+        {"integrate rigidbodies", RESOURCE_VELOCITIES, RESOURCE_TRANSFORMS|RESOURCE_VELOCITIES, [&world, dt]() { IntegrateRigidbodies(world, dt); }},
+        {"update box colliders", RESOURCE_TRANSFORMS, RESOURCE_COLLIDERS, [&world]() { UpdateBoxColliders(world); }},
+        {"sync sprites", RESOURCE_TRANSFORMS, RESOURCE_SPRITES, [&world]() { SyncSprites(world); }},
+    });
+}
+
+/*
+ * Creates a sprite component drawing a texture.
+ *
+ * \param texture The texture being rendered.
+ * \param z Value used to determine which order entities are rendered in.
+ * \param layer The render layer the sprite is drawn on.
+ */
+SpriteData MakeSpriteData(std::shared_ptr<LTexture> texture, int z, int layer)
+{
+    SpriteData data;
+    data.sprite = renderManager.AddSprite(texture, nullptr, z, layer);
+    return data;
+}
+
+/*
+ * Creates an entity from a game object's transform and the data of its `Rigidbody`,
+ * `BoxCollider` and `TextureRenderer` components, if it has them.
+ * The object is left unchanged, so it is usually destroyed afterwards.
+ *
+ * \returns The new entity.
+ */
+Entity EntityFromObject(EntityWorld& world, std::shared_ptr<GameObject> object)
+{
+    Entity entity = world.CreateEntity(TransformData{object->Position(), object->Scale()});
+
+    auto rigidbody = object->GetComponent<Rigidbody>();
+    if (rigidbody != nullptr) {
+        RigidbodyData body;
+        body.velocity = rigidbody->Velocity();
+        body.acceleration = rigidbody->Acceleration();
+        body.mass = rigidbody->Mass();
+        body.friction = rigidbody->FrictionCoefficient();
+        body.moveable = rigidbody->Moveable();
+        body.gravity = rigidbody->GravityEnabled();
+        world.AddComponent(entity, body);
+    }
+
+    auto collider = object->GetComponent<BoxCollider>();
+    if (collider != nullptr) world.AddComponent(entity, BoxColliderData{collider->GetBoundingBox()});
+
+    auto renderer = object->GetComponent<TextureRenderer>();
+    if (renderer != nullptr && renderer->texture != nullptr) {
+        world.AddComponent(entity, MakeSpriteData(renderer->texture, renderer->Z(), renderer->Layer()));
+    }
+
+    return entity;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <memory>
+
+#include "EntityWorld.hpp"
+#include "Components.hpp"
+
+// forwards declaration
+class GameObject;
+class LTexture;
+
+void IntegrateRigidbodies(EntityWorld& world, float dt);
+void UpdateBoxColliders(EntityWorld& world);
+void SyncSprites(EntityWorld& world);
+void RunSystems(EntityWorld& world, float dt);
+
+SpriteData MakeSpriteData(std::shared_ptr<LTexture> texture, int z = 0, int layer = 0);
+Entity EntityFromObject(EntityWorld& world, std::shared_ptr<GameObject> object);
@@ -30,13 +30,6 @@ void AudioPlayer::Destroy()
 {
     GameObject::Destroy();
     audio = nullptr;
-    s = nullptr;
-}
-
-/* This is just to access self as a shared pointer for self destruction */
-void AudioPlayer::AssignComponents(std::shared_ptr<GameObject> self)
-{
-    s = self;
 }
 
 /* 
@@ -51,7 +44,7 @@ void AudioPlayer::Update()
         time_remaining -= gTime.deltaTime();
         // audio done playing
         if (time_remaining<=0.0f) {
-            if (terminate) DestroyObject(s); // kill yourself in minecraft
+            if (terminate) DestroyObject(Handle()); // kill yourself in minecraft
             else playing = false; // stop playing
         }
     }
@@ -13,8 +13,6 @@ class AudioPlayer : public GameObject
 
         virtual void Destroy();
 
-        virtual void AssignComponents(std::shared_ptr<GameObject> self);
-
         virtual void Update();
 
         void Play(int channel = -1, int loops = 0);
@@ -37,7 +35,4 @@ class AudioPlayer : public GameObject
         bool terminate;
         /* Whether the audio is currently playing. */
         bool playing = false;
-
-        /* Shared pointer to self (for self destruction) */
-        std::shared_ptr<GameObject> s;
 };
\ No newline at end of file
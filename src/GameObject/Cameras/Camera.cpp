@@ -29,6 +29,9 @@ Camera::~Camera()
 void Camera::Destroy()
 {
     GameObject::Destroy();
+    // don't render a destroyed camera
+    renderManager.RemoveCamera(this);
+    for (auto& cache : caches) cache = LayerCache();
 }
 
 /* The region and position of the region viewed by the camera. */
@@ -38,20 +41,331 @@ float Camera::Zoom() const { return zoom; }
 /* Set how big/small the camera renders things. */
 void Camera::SetZoom(float newZoom) { zoom = newZoom; }
 
-/* Renders every enabled TextureRenderer in the global rendererManager vector */
-void Camera::Update()
+/* Bitmask of the render layers this camera draws. Bit `n` represents layer `n`. */
+unsigned int Camera::LayerMask() const { return layer_mask; }
+/* Set the bitmask of render layers this camera draws. Bit `n` represents layer `n`. */
+void Camera::SetLayerMask(unsigned int mask) { layer_mask = mask; }
+/* Include or exclude a single render layer from the camera's layer mask. */
+void Camera::ShowLayer(int layer, bool show)
+{
+    if (layer<0 || layer>=RENDER_LAYERS) return;
+    if (show) layer_mask |= (1u<<layer);
+    else layer_mask &= ~(1u<<layer);
+}
+
+/* 
+ * Centres the camera's rect on its position, and queues the camera to be
+ * rendered at the end of the frame. Runs after every `LateUpdate`, so the
+ * camera draws where anything following an object has moved it to this frame.
+ */
+void Camera::PreRender()
 {
     // centre camera rect on object position
     Vector2 view = Scale() & GetWindowResolution(), 
             origin = Position()-(view/2.0f);
     cam = {origin.x, origin.y, view.x, view.y};
 
-    // iterate through each renderer
-    for (auto& renderer : renderManager.renderers) {
-        // if the renderer is enabled, render it with reference to this camera 
-        if (renderer->Enabled()) {
-            renderer->Update();
-            renderer->Render(this);
+    renderManager.QueueCamera(this);
+}
+
+/*
+ * The transform from game space to pixels in the camera's region of the screen.
+ * Computed once, then applied to everything the camera draws.
+ * 
+ * \param renderRelative Whether the transform is for things that move with the camera.
+ * If `false`, things are fixed to the window, and the transform only describes the region.
+ */
+ViewTransform Camera::View(bool renderRelative) const
+{
+    if (!renderRelative) return {1.0f, Vector2_Zero, cam.w, cam.h};
+    if (view_overridden) return view_override;
+    // zoom towards the camera's position, then move to the camera's region
+    Vector2 cp = Position();
+    return {zoom, cp - (cp*zoom) - Vector2(cam.x, cam.y), cam.w, cam.h};
+}
+
+/*
+ * Finds where a rect in the game appears on screen when viewed by this camera,
+ * snapped to whole pixels.
+ * 
+ * \param area The rect in game space.
+ * \param renderRelative Whether the rect moves with the camera, or is fixed to the window.
+ * \param rend_rect Pointer to store the on screen rect in.
+ * 
+ * \returns `true` if the rect is within the camera's view. `false` if it is outside, and shouldn't be rendered.
+ */
+bool Camera::ScreenRect(RectF area, bool renderRelative, SDL_Rect *rend_rect) const
+{
+    ViewTransform t = View(renderRelative);
+    Vector2 p0 = t.Apply(Vector2(area.x, area.y)), p1 = t.Apply(Vector2(area.x+area.w, area.y+area.h));
+
+    // create the rect from its corners, so that adjacent rects share edges
+    int x = (int)std::floor(p0.x), y = (int)std::floor(p0.y);
+    *rend_rect = {x, y, (int)std::floor(p1.x) - x, (int)std::floor(p1.y) - y};
+
+    // check if outside of camera view
+    if (rend_rect->x<-rend_rect->w || rend_rect->x>t.width ||
+        rend_rect->y<-rend_rect->h || rend_rect->y>t.height) {
+        gWindow->countCulled();
+        return false;
+    }
+    return true;
+}
+
+/* 
+ * Renders every enabled TextureRenderer and sprite on the layers in the camera's layer mask, 
+ * in order of z value. Layers excluded from the mask are never visited.
+ * 
+ * Cached layers are drawn as a single texture, at the z value of their lowest renderer.
+ * 
+ * \note Renderers should already have been prepared for the frame. This is handled
+ * by `RenderManager::Render`.
+ */
+void Camera::Render()
+{
+    // each layer has up to three sources: renderers and sprites, or a cache and what it couldn't hold
+    RenderSource sources[RENDER_LAYERS*3];
+    int n = 0;
+    for (int i=0; i<RENDER_LAYERS; i++)
+    {
+        if (!(layer_mask & (1u<<i))) continue;
+        auto &renderers = renderManager.layers[i];
+        auto &sprites = renderManager.sprite_layers[i];
+        if (renderers.empty() && sprites.empty()) continue;
+
+        if (renderManager.LayerCached(i) && update_cache(i)) {
+            LayerCache& cache = caches[i];
+            if (cache.texture != nullptr) sources[n++].cache = &cache;
+            if (!cache.live.empty()) sources[n++].renderers = &cache.live;
+            if (!cache.live_sprites.empty()) sources[n++].sprites = &cache.live_sprites;
+        } else {
+            if (!renderers.empty()) sources[n++].renderers = &renderers;
+            if (!sprites.empty()) sources[n++].sprites = &sprites;
+        }
+    }
+    render_sources(sources, n);
+}
+
+/*
+ * Merges sorted render sources, always rendering the lowest z next.
+ * 
+ * \param sources The sources to render. Their positions are advanced.
+ * \param n The number of sources.
+ * \param relativeOnly Skip renderers and sprites fixed to the window.
+ */
+void Camera::render_sources(RenderSource *sources, int n, bool relativeOnly)
+{
+    auto& sprites = renderManager.sprites;
+    while (true)
+    {
+        int next = -1, next_z = 0;
+        for (int i=0; i<n; i++) {
+            RenderSource& s = sources[i];
+            int z;
+            if (s.cache != nullptr) z = s.cache->z;
+            else if (s.renderers != nullptr && s.pos < s.renderers->size()) z = (*s.renderers)[s.pos]->Z();
+            else if (s.sprites != nullptr && s.pos < s.sprites->size()) z = sprites[(*s.sprites)[s.pos]].z;
+            else continue;
+            if (next == -1 || z < next_z) {
+                next = i; next_z = z;
+            }
+        }
+        // all sources rendered
+        if (next == -1) break;
+
+        RenderSource& s = sources[next];
+        if (s.cache != nullptr) {
+            flush_batch();
+            render_cache(*s.cache);
+            s.cache = nullptr;
+        } else if (s.renderers != nullptr) {
+            auto renderer = (*s.renderers)[s.pos++];
+            if (!renderer->Enabled() || (relativeOnly && !renderer->RenderRelative())) continue;
+            // simple renderers are drawn in batches. others draw themselves, after everything before them
+            RenderQuad quad;
+            if (renderer->Batched() && renderer->GetQuad(&quad)) batch_quad(quad, renderer->rect, renderer->RenderRelative());
+            else {
+                flush_batch();
+                renderer->Render(this);
+            }
+        } else {
+            const Sprite& sprite = sprites[(*s.sprites)[s.pos++]];
+            if (relativeOnly && !sprite.render_relative) continue;
+            if (sprite.owner != nullptr && !sprite.owner->Enabled()) continue;
+            RenderQuad quad;
+            quad.texture = sprite.texture.get();
+            quad.clip = sprite.clip;
+            quad.flip = sprite.flip;
+            quad.tint = sprite.tint;
+            batch_quad(quad, sprite.rect, sprite.render_relative);
+        }
+    }
+    flush_batch();
+}
+
+/* Adds a quad to be drawn with the current batch. Draws the batch first if the quad uses a different transform. */
+void Camera::batch_quad(const RenderQuad& quad, RectF rect, bool renderRelative)
+{
+    if (quad.texture == nullptr) return;
+    if (!batch.empty() && renderRelative != batch_relative) flush_batch();
+    batch_relative = renderRelative;
+    batch.push_back(quad);
+    batch_rects.push_back({rect.x, rect.y, rect.w, rect.h});
+}
+
+/*
+ * Transforms every batched rect to the screen in a single pass, then draws the quads in order.
+ * Rects keep sub-pixel positions and sizes, so moving and zooming don't jitter.
+ */
+void Camera::flush_batch()
+{
+    int n = batch.size();
+    if (n == 0) return;
+
+    // the same transform for every rect, in a loop the compiler can vectorise
+    ViewTransform t = View(batch_relative);
+    float s = t.scale, ox = t.offset.x, oy = t.offset.y;
+    SDL_FRect *r = batch_rects.data();
+    for (int i=0; i<n; i++) {
+        r[i].x = r[i].x*s + ox;
+        r[i].y = r[i].y*s + oy;
+        r[i].w *= s;
+        r[i].h *= s;
+    }
+
+    int culled = 0;
+    for (int i=0; i<n; i++)
+    {
+        // check if outside of camera view
+        if (r[i].x+r[i].w < 0.0f || r[i].x > t.width || r[i].y+r[i].h < 0.0f || r[i].y > t.height) {
+            culled++;
+            continue;
+        }
+
+        RenderQuad& quad = batch[i];
+        quad.texture->renderF(&r[i], (quad.clip.w>0 && quad.clip.h>0)? &quad.clip : NULL, quad.flip, quad.tint);
+    }
+    gWindow->countCulled(culled);
+
+    batch.clear();
+    batch_rects.clear();
+}
+
+/*
+ * Blend mode cached layers are drawn with. Drawing onto a cleared texture with normal blending leaves
+ * its colours already multiplied by their alpha, so they mustn't be multiplied again when it is drawn.
+ */
+static SDL_BlendMode premultiplied_blend()
+{
+    static SDL_BlendMode mode = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    return mode;
+}
+
+/*
+ * Redraws the camera's cache of a render layer, if anything on the layer has changed
+ * or the camera's zoom has changed since it was last drawn.
+ * 
+ * \returns `true` if the cache can be used. `false` if the layer must be drawn uncached.
+ */
+bool Camera::update_cache(int layer)
+{
+    LayerCache& cache = caches[layer];
+    unsigned int version = renderManager.LayerVersion(layer);
+    if (cache.version == version && cache.zoom == zoom) return cache.usable;
+    cache.version = version;
+    cache.zoom = zoom;
+    cache.live.clear();
+    cache.live_sprites.clear();
+
+    // find the region of game space covered by the layer's renderers and sprites
+    auto& renderers = renderManager.layers[layer];
+    auto& sprites = renderManager.sprite_layers[layer];
+    float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;
+    bool found = false;
+    auto include = [&](RectF r, int z) {
+        if (!found) {
+            x0 = r.x; y0 = r.y; x1 = r.x+r.w; y1 = r.y+r.h;
+            cache.z = z;
+            found = true;
+        } else {
+            x0 = min(x0, r.x); y0 = min(y0, r.y);
+            x1 = max(x1, r.x+r.w); y1 = max(y1, r.y+r.h);
+            cache.z = min(cache.z, z);
         }
+    };
+    for (auto& renderer : renderers)
+    {
+        if (!renderer->Enabled()) continue;
+        // renderers fixed to the window can't be drawn into game space
+        if (!renderer->RenderRelative()) cache.live.push_back(renderer);
+        else include(renderer->rect, renderer->Z());
+    }
+    for (int index : sprites)
+    {
+        const Sprite& sprite = renderManager.sprites[index];
+        if (!sprite.render_relative) cache.live_sprites.push_back(index);
+        // hidden sprites aren't drawn onto the cache, so they mustn't grow it
+        else if (sprite.owner != nullptr && !sprite.owner->Enabled()) continue;
+        else include(sprite.rect, sprite.z);
+    }
+
+    cache.usable = true;
+    if (!found) {
+        cache.texture = nullptr;
+        return true;
     }
-}
\ No newline at end of file
+
+    // size the texture to the region at the current zoom
+    int w = (int)std::ceil((x1-x0)*zoom), h = (int)std::ceil((y1-y0)*zoom);
+    if (w<=0 || h<=0 || w>MAX_LAYER_CACHE_SIZE || h>MAX_LAYER_CACHE_SIZE) {
+        cache.texture = nullptr;
+        cache.usable = false;
+        return false;
+    }
+    if (cache.texture == nullptr) cache.texture = std::make_shared<LTexture>(gWindow);
+    // renderers without premultiplied blending can't be cached without their alpha being applied twice
+    if (!cache.texture->solidColour({0,0,0,0}, w, h) || !cache.texture->setBlendMode(premultiplied_blend())) {
+        cache.texture = nullptr;
+        cache.usable = false;
+        return false;
+    }
+    cache.bounds = {x0, y0, x1-x0, y1-y0};
+
+    // draw with a view that puts the region's top left at the texture's origin
+    view_override = {zoom, Vector2(-x0*zoom, -y0*zoom), (float)w, (float)h};
+    view_overridden = true;
+
+    // draw everything onto the texture in z order, with a single render target switch
+    if (cache.texture->setAsRenderTarget()) {
+        RenderSource sources[2];
+        sources[0].renderers = &renderers;
+        sources[1].sprites = &sprites;
+        render_sources(sources, 2, true);
+        cache.texture->resetRenderTarget();
+    }
+
+    view_overridden = false;
+    return true;
+}
+
+/* Draws a cached layer's texture over the region of game space it covers. */
+void Camera::render_cache(LayerCache& cache)
+{
+    ViewTransform t = View();
+    Vector2 origin = t.Apply(Vector2(cache.bounds.x, cache.bounds.y));
+    SDL_Rect rend_rect = {
+        (int)std::floor(origin.x), (int)std::floor(origin.y),
+        cache.texture->getWidth(), cache.texture->getHeight()
+    };
+
+    // check if outside of camera view
+    if (rend_rect.x<-rend_rect.w || rend_rect.x>t.width ||
+        rend_rect.y<-rend_rect.h || rend_rect.y>t.height) {
+        gWindow->countCulled();
+        return;
+    }
+
+    cache.texture->render(&rend_rect);
+}
@@ -1,6 +1,42 @@
 #pragma once
 
 #include "../GameObject.hpp"
+#include "../Renderer/RenderManager.hpp"
+#include "../../sdl/LTexture.hpp"
+
+/* The largest width or height of a cached layer texture, in pixels. Larger layers are drawn uncached. */
+#define MAX_LAYER_CACHE_SIZE 4096
+
+/* A camera's drawing of a cached render layer */
+struct LayerCache {
+    /* The layer's renderers drawn at the camera's zoom. `nullptr` if there was nothing to draw. */
+    std::shared_ptr<LTexture> texture = nullptr;
+    /* The region of game space covered by the texture */
+    RectF bounds;
+    /* The z value the texture is drawn at, the lowest of the renderers drawn onto it */
+    int z = 0;
+    /* Renderers and sprites on the layer that don't move with the camera, so are drawn directly */
+    std::vector<TextureRenderer*> live;
+    std::vector<int> live_sprites;
+    /* The layer version and zoom the texture was drawn with */
+    unsigned int version = 0;
+    float zoom = 0.0f;
+    /* Whether the layer could be cached. `false` if the layer is too big */
+    bool usable = false;
+};
+
+/* Maps points in game space to pixels in a camera's region of the screen, as `point*scale + offset` */
+struct ViewTransform {
+    float scale = 1.0f;
+    Vector2 offset = Vector2_Zero;
+    /* The size of the region being drawn to, in pixels */
+    float width = 0.0f, height = 0.0f;
+
+    /* The pixel a point in game space is drawn at */
+    Vector2 Apply(Vector2 p) const { return Vector2(p.x*scale + offset.x, p.y*scale + offset.y); }
+    /* The point in game space drawn at a pixel */
+    Vector2 Inverse(Vector2 p) const { return Vector2((p.x-offset.x)/scale, (p.y-offset.y)/scale); }
+};
 
 /* Camera that renders all `TextureRenderer`s to an area on the screen */
 class Camera : public GameObject
@@ -12,11 +48,19 @@ class Camera : public GameObject
 
         virtual void Destroy();
 
-        virtual void Update();
+        virtual void PreRender();
+        virtual void Render();
+
+        ViewTransform View(bool renderRelative = true) const;
+        bool ScreenRect(RectF area, bool renderRelative, SDL_Rect *rend_rect) const;
 
         RectF camera() const;
         float Zoom() const;
         void SetZoom(float newZoom);
+
+        unsigned int LayerMask() const;
+        void SetLayerMask(unsigned int mask);
+        void ShowLayer(int layer, bool show = true);
         
     private:
 
@@ -24,4 +68,35 @@ class Camera : public GameObject
         RectF cam;
         /* How big/small the camera renders things. */
         float zoom;
+        /* Bitmask of the render layers this camera draws. Bit `n` represents layer `n`. */
+        unsigned int layer_mask = ALL_RENDER_LAYERS;
+
+        /* This camera's drawings of each cached render layer */
+        LayerCache caches[RENDER_LAYERS];
+
+        /* A z-sorted list of renderers or sprites, or a cached layer, merged with others when rendering */
+        struct RenderSource {
+            const std::vector<TextureRenderer*> *renderers = nullptr;
+            const std::vector<int> *sprites = nullptr;
+            LayerCache *cache = nullptr;
+            size_t pos = 0;
+        };
+
+        void render_sources(RenderSource *sources, int n, bool relativeOnly = false);
+
+        /* Quads waiting to be transformed and drawn together, and their rects */
+        std::vector<RenderQuad> batch;
+        std::vector<SDL_FRect> batch_rects;
+        /* Whether the batched quads move with the camera */
+        bool batch_relative = true;
+
+        void batch_quad(const RenderQuad& quad, RectF rect, bool renderRelative);
+        void flush_batch();
+
+        /* Replaces the camera's view transform while drawing a cached layer */
+        ViewTransform view_override;
+        bool view_overridden = false;
+
+        bool update_cache(int layer);
+        void render_cache(LayerCache& cache);
 };
\ No newline at end of file
@@ -11,7 +11,7 @@
  * \param object The object that the component is attached to.
  * \param startEnabled Whether or not the component is active on creation. `true` by default.
  */
-BoxCollider::BoxCollider(std::shared_ptr<GameObject> object, bool startEnabled)
+BoxCollider::BoxCollider(ObjectHandle object, bool startEnabled)
 : ObjectComponent(object, startEnabled)
 {
     // set up bounding box
@@ -30,21 +30,22 @@ BoxCollider::~BoxCollider()
 /* Remove self from global colliders vector */
 void BoxCollider::Destroy()
 {
+    // colliders it was touching shouldn't keep a handle to a destroyed object
+    detach_partners();
     ObjectComponent::Destroy();
     colliderManager.RemoveCollider(this);
     collisions.clear();
 }
 
 /*
- * Updates bounding box based on object position.
- * Checks for collision with all other BoxColliders. After `Update` is called,
+ * Checks for collision with all other BoxColliders. After `CollisionUpdate` is called,
  * `GetCollisions` will successfully return all objects currently in collision with.
+ * Every collider's bounding box is updated before any collider checks for collisions.
  */
-void BoxCollider::Update()
+void BoxCollider::CollisionUpdate()
 {
-    // update bounding box
-    Vector2 s = obj->Scale(), origin = obj->Position()-(s/2.0f);
-    bounding_box = {origin.x, origin.y, s.x, s.y};
+    // set aside colliders turned off since the last check, so they aren't visited
+    GameObject::RefreshToggled();
 
     // check other box colliders for collision
     for (auto& other : colliderManager.colliders) {
@@ -59,15 +60,31 @@ void BoxCollider::Update()
         }
     }
 
-    // remove deactivated collisions
-    for (auto it=collisions.begin(); it!=collisions.end(); it++) {
-        if (!it->first->Enabled()) {
-            obj->OnCollisionExit(it->first);
-            collisions.erase(it);
-        }
+    // remove collisions with objects that were deactivated or destroyed
+    for (auto it=collisions.begin(); it!=collisions.end();) {
+        if (it->first == nullptr || !it->first->Enabled()) {
+            ObjectHandle other = it->first;
+            it = collisions.erase(it);
+            obj->OnCollisionExit(other);
+        } else it++;
     }
 }
 
+/* Moves the collider in or out of the collider manager's main vector when turned on or off */
+void BoxCollider::refresh_active()
+{
+    ObjectComponent::refresh_active();
+    colliderManager.Refresh(this);
+}
+
+/* Centres the bounding box on the object, sized to its scale */
+void BoxCollider::UpdateBoundingBox()
+{
+    if (obj == nullptr) return;
+    Vector2 s = obj->Scale(), origin = obj->Position()-(s/2.0f);
+    bounding_box = {origin.x, origin.y, s.x, s.y};
+}
+
 /* The rectangular bounding box used for collision detection */
 RectF BoxCollider::GetBoundingBox() const { return bounding_box; }
 
@@ -148,6 +165,34 @@ void BoxCollider::add_collision(BoxCollider *other, Vector2 p)
     }
 }
 
+/* Ends every collision the collider is in, calling `OnCollisionExit` on both objects of each */
+void BoxCollider::clear_collisions()
+{
+    std::vector<ObjectHandle> others;
+    for (auto& p : collisions) others.push_back(p.first);
+    if (obj == nullptr) {
+        collisions.clear();
+        return;
+    }
+    for (auto& other : others) remove_collision(other);
+}
+
+/*
+ * Removes the collider's object from the collisions of every object it is colliding with,
+ * calling `OnCollisionExit` on them with the object's handle, which stops resolving once it is destroyed.
+ */
+void BoxCollider::detach_partners()
+{
+    ObjectHandle self = obj;
+    for (auto& p : collisions) {
+        GameObject *other = p.first.Get();
+        if (other == nullptr) continue;
+        auto collider = other->GetComponent<BoxCollider>();
+        if (collider == nullptr || collider->collisions.erase(self) == 0) continue;
+        other->OnCollisionExit(self);
+    }
+}
+
 /* Removes game objects from respective collider sets */
 void BoxCollider::remove_collision(BoxCollider *other)
 {
@@ -166,21 +211,27 @@ void BoxCollider::remove_collision(BoxCollider *other)
     }
 }
 
-/* Removes game objects from respective collider sets */
-void BoxCollider::remove_collision(std::shared_ptr<GameObject> obj, std::shared_ptr<BoxCollider> other)
+/*
+ * Removes game objects from respective collider sets.
+ *
+ * \param other The object being collided with.
+ * \param collider The other object's collider. Found from the object if `nullptr`.
+ */
+void BoxCollider::remove_collision(ObjectHandle other, BoxCollider *collider)
 {
     // remove item from collisions set
-    auto it = collisions.find(obj);
+    auto it = collisions.find(other);
     if (it != collisions.end()) {
         collisions.erase(it);
-        obj->OnCollisionExit(obj);
+        obj->OnCollisionExit(other);
     }
 
     // remove self from other collider's set
-    if (other==nullptr) other=obj->GetComponent<BoxCollider>();
-    it = other->collisions.find(obj);
-    if (it != other->collisions.end()) {
-        other->collisions.erase(it);
-        other->obj->OnCollisionExit(obj);
+    if (collider==nullptr && other!=nullptr) collider=other->GetComponent<BoxCollider>().get();
+    if (collider==nullptr) return;
+    it = collider->collisions.find(obj);
+    if (it != collider->collisions.end()) {
+        collider->collisions.erase(it);
+        other->OnCollisionExit(obj);
     }
 }
\ No newline at end of file
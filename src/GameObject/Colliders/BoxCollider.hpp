@@ -8,7 +8,7 @@
 /* Container for information about a collision */
 struct Collision {
     /* The other object being collided with */
-    std::shared_ptr<GameObject> other;
+    ObjectHandle other;
     /* The point of collision */
     Vector2 point;
 };
@@ -21,13 +21,14 @@ class BoxCollider : public ObjectComponent
 {
     public:
 
-        BoxCollider(std::shared_ptr<GameObject> object, bool startEnabled = true);
+        BoxCollider(ObjectHandle object, bool startEnabled = true);
         ~BoxCollider();
 
         virtual void Destroy();
 
-        virtual void Update();
+        virtual void CollisionUpdate();
 
+        void UpdateBoundingBox();
         RectF GetBoundingBox() const;
 
         bool CheckCollision(BoxCollider *other, Vector2 *p);
@@ -36,12 +37,25 @@ class BoxCollider : public ObjectComponent
 
         void add_collision(BoxCollider *other, Vector2 p);
         void remove_collision(BoxCollider *other);
-        void remove_collision(std::shared_ptr<GameObject> obj, std::shared_ptr<BoxCollider> other = nullptr);
+        void remove_collision(ObjectHandle other, BoxCollider *collider = nullptr);
         
+    protected:
+
+        virtual void refresh_active();
+
     private:
 
         /* The box used for collision detection, centred on the object's position */
         RectF bounding_box;
         /* Set of all objects currently being collided with */
-        std::unordered_map<std::shared_ptr<GameObject>,Collision> collisions;
+        std::unordered_map<ObjectHandle,Collision> collisions;
+
+        /* The collider's position in the collider manager's vector. `-1` when not in it. */
+        int collider_index = -1;
+        /* Whether the collider is in the collider manager's disabled vector, rather than the main one */
+        bool collider_parked = false;
+        friend class ColliderManager;
+
+        void clear_collisions();
+        void detach_partners();
 };
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "ColliderManager.hpp"
 #include "BoxCollider.hpp"
+#include "../Tilemap/TilemapCollider.hpp"
+#include "../../JobSystem.hpp"
+
+#include <algorithm>
 
 ColliderManager::ColliderManager()
 {
@@ -9,30 +13,122 @@ ColliderManager::ColliderManager()
 ColliderManager::~ColliderManager()
 {
     colliders.clear();
+    disabled_colliders.clear();
+    static_colliders.clear();
 }
 
 /* Add a collider object to the global vector. */
 void ColliderManager::AddCollider(BoxCollider *collider)
 {
+    if (collider->collider_index != -1) return;
+    collider->collider_index = colliders.size();
     colliders.push_back(collider);
 }
 
 /* 
- * Removes the BoxCollider from the vector. If the pointer is included multiple
- * times, only the first instance is removed. Does nothing if the BoxCollider
- * is not in the vector.
+ * Removes the BoxCollider from its vector, by moving the last collider into its place.
+ * Does nothing if the BoxCollider is not in either vector.
  */
 void ColliderManager::RemoveCollider(BoxCollider *collider)
 {
-    // iterate through all pointers
-    for (auto it=colliders.begin(), e = colliders.end(); it!=e; it++) {
-        // when found, remove the matching element and end search
+    if (collider->collider_index == -1) return;
+    auto& list = (collider->collider_parked)? disabled_colliders : colliders;
+    list[collider->collider_index] = list.back();
+    list[collider->collider_index]->collider_index = collider->collider_index;
+    list.pop_back();
+    collider->collider_index = -1;
+    collider->collider_parked = false;
+}
+
+/* Removes every collider belonging to an object waiting to be destroyed, in a single pass. */
+void ColliderManager::RemovePending()
+{
+    for (auto list : {&colliders, &disabled_colliders}) {
+        auto end = std::remove_if(list->begin(), list->end(), [](BoxCollider *collider) {
+            if (!collider->PendingDestroy()) return false;
+            collider->collider_index = -1;
+            collider->collider_parked = false;
+            return true;
+        });
+        if (end == list->end()) continue;
+        list->erase(end, list->end());
+        for (int i = 0; i < list->size(); i++) (*list)[i]->collider_index = i;
+    }
+}
+
+/*
+ * Moves a collider that has been turned off out of the main vector, ending its collisions, or
+ * moves a collider that has been turned back on into it. Called for colliders under an object
+ * that was turned on or off, so disabled colliders aren't visited every frame.
+ */
+void ColliderManager::Refresh(BoxCollider *collider)
+{
+    if (collider->collider_index == -1) return;
+    bool active = collider->Enabled();
+    if (active != collider->collider_parked) return;
+    move_collider(collider, !active);
+    if (!active) collider->clear_collisions();
+}
+
+/* Add a static collider object to the global vector. */
+void ColliderManager::AddStaticCollider(TilemapCollider *collider)
+{
+    static_colliders.push_back(collider);
+}
+
+/* 
+ * Removes the static collider from the vector. 
+ * Does nothing if the collider is not in the vector.
+ */
+void ColliderManager::RemoveStaticCollider(TilemapCollider *collider)
+{
+    for (auto it=static_colliders.begin(), e = static_colliders.end(); it!=e; it++) {
         if (*it == collider) {
-            colliders.erase(it);
+            static_colliders.erase(it);
             break;
         }
     }
 }
 
+/*
+ * Finds the static geometry overlapping an area, from every enabled static collider.
+ * 
+ * \param area The rect in game space to search.
+ * \param out Pointer to the vector to append overlapping rects to.
+ * \param friction Pointer to store the highest friction coefficient of the colliders found, if any.
+ */
+void ColliderManager::QueryStatic(Math::RectF area, std::vector<Math::RectF> *out, float *friction)
+{
+    for (auto& collider : static_colliders)
+    {
+        if (!collider->Enabled()) continue;
+        size_t found = out->size();
+        collider->Query(area, out);
+        if (friction && out->size()>found) *friction = Math::max(*friction, collider->FrictionCoefficient());
+    }
+}
+
+/*
+ * Moves every enabled collider's bounding box to its object, in parallel. Called by scenes before
+ * the collision phase, so colliders check for collisions against where everything is this frame.
+ */
+void ColliderManager::UpdateBoundingBoxes()
+{
+    GameObject::RefreshToggled();
+    jobSystem.ParallelFor(colliders.size(), 256, [this](int begin, int end) {
+        for (int i = begin; i < end; i++) colliders[i]->UpdateBoundingBox();
+    });
+}
+
+/* Moves a collider between the main and disabled vectors */
+void ColliderManager::move_collider(BoxCollider *collider, bool parked)
+{
+    RemoveCollider(collider);
+    auto& list = (parked)? disabled_colliders : colliders;
+    collider->collider_index = list.size();
+    collider->collider_parked = parked;
+    list.push_back(collider);
+}
+
 // create global manager object
 ColliderManager colliderManager = ColliderManager();
\ No newline at end of file
@@ -2,9 +2,11 @@
 
 #include <vector>
 #include <memory>
+#include "../../Math/Math.hpp"
 
 // forwards declaration
 class BoxCollider;
+class TilemapCollider;
 
 /* Stores all `BoxCollider` components, to be used for collision detection. */
 class ColliderManager
@@ -16,9 +18,25 @@ class ColliderManager
 
         void AddCollider(BoxCollider *collider);
         void RemoveCollider(BoxCollider *collider);
+        void RemovePending();
+        void Refresh(BoxCollider *collider);
+        void UpdateBoundingBoxes();
 
-        /* Vector of pointers to all BoxColliders. */
+        void AddStaticCollider(TilemapCollider *collider);
+        void RemoveStaticCollider(TilemapCollider *collider);
+
+        void QueryStatic(Math::RectF area, std::vector<Math::RectF> *out, float *friction = nullptr);
+
+        /* Vector of pointers to all enabled BoxColliders, as of the last refresh. */
         std::vector<BoxCollider*> colliders;
+        /* BoxColliders that were disabled at the last refresh, left out of collision checks. */
+        std::vector<BoxCollider*> disabled_colliders;
+        /* Vector of pointers to all colliders with fixed geometry, such as tilemaps. */
+        std::vector<TilemapCollider*> static_colliders;
+
+    private:
+
+        void move_collider(BoxCollider *collider, bool parked);
 };
 
 // create global object
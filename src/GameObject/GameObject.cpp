@@ -1,5 +1,48 @@
 #include "GameObject.hpp"
 #include "Colliders/BoxCollider.hpp"
+#include "Renderer/RenderManager.hpp"
+#include "Colliders/ColliderManager.hpp"
+#include "../JobSystem.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+
+/* Objects with components waiting to be removed at the end of the frame */
+static std::vector<ObjectHandle> compaction_queue;
+
+/* Incremented whenever any object is turned on or off, so every object's cached enabled state is out of date */
+static std::atomic<unsigned int> enabled_epoch{1};
+/* Objects turned on, off or removed since update lists and managers were last brought up to date */
+static std::vector<ObjectHandle> toggled_roots;
+
+/* Number of locks shared between objects working out their world transform */
+#define TRANSFORM_LOCKS 64
+/* Objects lock one of these, picked by address, while working out their world transform on a worker thread */
+static std::mutex transform_locks[TRANSFORM_LOCKS];
+
+/* The scale that, multiplied by the parent's, gives `scale`. Axes where the parent's scale is 0 are kept as they are. */
+static Vector2 relative_scale(Vector2 scale, Vector2 parentScale)
+{
+    if (parentScale.x != 0.0f) scale.x /= parentScale.x;
+    if (parentScale.y != 0.0f) scale.y /= parentScale.y;
+    return scale;
+}
+
+/*
+ * Stops the game if a function that changes objects is called from a job, such as `ParallelUpdate`.
+ * Other threads may be reading the object at the same time.
+ */
+static void require_main_thread(const char *function)
+{
+    if (!JobSystem::InJob()) return;
+    printf("GameObject::%s can't be called from a job, such as ParallelUpdate.\n", function);
+    fflush(stdout);
+    // other threads are still running jobs, so don't run global destructors
+    _Exit(1);
+}
 
 /*
  * Baseplate object in game space, contains a vector of components.
@@ -9,21 +52,29 @@
  * \param startEnabled Whether or not the object is enabled on creation. `true` by default.
  */
 GameObject::GameObject(Vector2 position, Vector2 scale, bool startEnabled)
-: pos(position), scale(scale), enabled(startEnabled)
+: local_pos(position), local_scale(scale), enabled(startEnabled)
 {
-
+    handle = ObjectHandle::Register(this);
 }
 
 GameObject::~GameObject()
 {
     Destroy();
+    ObjectHandle::Unregister(handle);
 }
 
 /* Removes all components, and components' components */
 void GameObject::Destroy() {
     for (auto& comp : components) comp->Destroy();
     components.clear();
+    if (update_list != nullptr) update_list->Remove(this);
+    update_list = nullptr;
+    parent = nullptr;
+    type_index.clear();
+    for (auto& sprite : sprites) renderManager.RemoveSprite(sprite);
+    sprites.clear();
     enabled = false;
+    enabled_cache = 0;
 }
 
 /* Update's the game object. Does nothing by default, redefine in subclass definitions. */
@@ -32,49 +83,132 @@ void GameObject::Update()
     
 }
 
-/* Calls `Update` for all object components. Calls `UpdateComponents` for all components as well. */
+/*
+ * Update run at a fixed rate, `gTime.fixedDeltaTime()` seconds apart, before everything else in the frame.
+ * May run several times in one frame, or not at all. Does nothing by default, redefine in subclass definitions.
+ */
+void GameObject::FixedUpdate()
+{
+
+}
+
+/*
+ * Update run in the collision phase, once every collider's bounding box has been placed. Used by
+ * colliders to find collisions. Does nothing by default, redefine in subclass definitions.
+ */
+void GameObject::CollisionUpdate()
+{
+
+}
+
+/*
+ * Update run in the physics phase, right after collisions are found. Used by rigidbodies to respond to
+ * those collisions and move, before any `Update`. Does nothing by default, redefine in subclass definitions.
+ */
+void GameObject::PhysicsUpdate()
+{
+
+}
+
+/*
+ * Update run once every object's `Update` and `ParallelUpdate` are done. Suited to objects
+ * that follow others, such as cameras. Does nothing by default, redefine in subclass definitions.
+ */
+void GameObject::LateUpdate()
+{
+
+}
+
+/*
+ * Last update of the frame, run after `LateUpdate` and before rendering.
+ * Used by cameras to queue themselves. Does nothing by default, redefine in subclass definitions.
+ */
+void GameObject::PreRender()
+{
+
+}
+
+/*
+ * Update that can run on a worker thread, at the same time as the `ParallelUpdate` of other objects.
+ * Called every frame after every object's `Update`. Does nothing by default, redefine in subclass definitions.
+ *
+ * Must only change the object's own data. It must not move, resize, enable or disable any object,
+ * itself included, as other threads may be reading its transform. It must not add, remove or destroy
+ * objects, change other objects, or call SDL. Doing any of these stops the game with an error.
+ * Reading any object, transforms included, is fine, as nothing changes them during the phase.
+ */
+void GameObject::ParallelUpdate()
+{
+
+}
+
+/*
+ * Calls `Update` for all object components. Calls `UpdateComponents` for all components as well.
+ * Objects in a scene are updated by the scene's update list instead, so this is only called on
+ * objects whose type redefines it.
+ */
 void GameObject::UpdateComponents()
 {
     for (int i=0; i<components.size(); i++) {
         auto comp = components[i];
         if (comp!=nullptr && comp->Enabled()) comp->Update();
+        // components outside of an update list have their parallel update on this thread
+        if (comp!=nullptr && comp->Enabled()) comp->ParallelUpdate();
         if (comp!=nullptr && comp->Enabled()) comp->UpdateComponents();
     }
 }
 
-/* Turn the object on/off. Sets enabled for all component objects. */
+/*
+ * Turn the object on/off. Components are enabled only while their parents are, so turning an
+ * object off turns off everything under it, without visiting it. Components keep their own setting,
+ * so a component turned off by itself stays off when its parent is turned back on.
+ */
 void GameObject::SetEnabled(bool enable) 
 {
-    // assign for self
+    if (enable == enabled) return;
+    require_main_thread("SetEnabled");
     enabled = enable;
-    // set enabled for all component objects 
-    for (auto& component : components) {
-        component->SetEnabled(enable);
-    }
+    active_changed();
 }
 
-/* Assign the object's position. Moves all component objects. */
+/* 
+ * Assign the object's position in game space. Components move with the object, 
+ * but aren't visited until their position is next read.
+ */
 void GameObject::SetPosition(Vector2 newPosition) 
 {
-    Vector2 disp = newPosition - pos;
-    // assign position for self
-    pos = newPosition;
-    // move components according to displacement
-    for (auto& component : components) {
-        component->SetPosition(component->Position() + disp);
-    }
+    if (parent != nullptr) newPosition -= parent->Position();
+    SetLocalPosition(newPosition);
 }
 
-/* Sets this object's scale. Resizes all component objects accoridngly. */
+/* 
+ * Sets this object's scale. Components are resized by the same factor,
+ * but aren't visited until their scale is next read.
+ */
 void GameObject::SetScale(Vector2 newScale) 
 {
-    Vector2 diff = {newScale.x/scale.x, newScale.y/scale.y};
-    // resize for self
-    scale = newScale;
-    // resize all components accordingly
-    for (auto& component : components) {
-        component->SetScale(component->Scale()*diff);
-    }
+    if (parent != nullptr) newScale = relative_scale(newScale, parent->Scale());
+    SetLocalScale(newScale);
+}
+
+/* Assign the object's position relative to its parent. The same as `SetPosition` for objects without a parent. */
+void GameObject::SetLocalPosition(Vector2 newPosition)
+{
+    // nothing to do when the object isn't actually moving
+    if (newPosition == local_pos) return;
+    require_main_thread("SetLocalPosition");
+    local_pos = newPosition;
+    local_version++;
+}
+
+/* Sets this object's scale as a multiple of its parent's. The same as `SetScale` for objects without a parent. */
+void GameObject::SetLocalScale(Vector2 newScale)
+{
+    // nothing to do when the object isn't actually resized
+    if (newScale == local_scale) return;
+    require_main_thread("SetLocalScale");
+    local_scale = newScale;
+    local_version++;
 }
 
 /* Assigns components given a shared pointer to itself. Does nothing, shoudl be redefined in subclass definitiions. */
@@ -83,20 +217,213 @@ void GameObject::AssignComponents(std::shared_ptr<GameObject> self)
 
 }
 
-/* Removes the specified object as a component of the game object */
-void GameObject::RemoveComponent(std::shared_ptr<GameObject> obj)
+/*
+ * Removes the specified object as a component of the game object. The component is disabled
+ * and hidden from component lookups straight away, but is only destroyed when `FlushDestroyed` is
+ * called at the end of the frame, so it is safe to remove components while they are updating.
+ *
+ * \param obj The component to remove. Does nothing if it isn't a component of this object.
+ */
+void GameObject::RemoveComponent(ObjectHandle obj)
 {
-    // search each component object
-    for (auto it = components.begin(); it != components.end(); it++) {
-        // if the object is found, remove it and end the search
-        if (*it == obj) {
-            (*it)->Destroy();
-            components.erase(it);
-            break;
+    GameObject *target = obj.Get();
+    // only this object's own components can be removed from it
+    if (target == nullptr || target->parent != this || target->pending_destroy) return;
+    require_main_thread("RemoveComponent");
+    target->pending_destroy = true;
+    // the removed object and everything under it stop updating, colliding and drawing straight away
+    target->active_changed();
+    if (!compaction_queued) {
+        compaction_queued = true;
+        compaction_queue.push_back(handle);
+    }
+}
+
+/*
+ * Destroys every component removed during the frame. Each object with removed components has them
+ * erased in one pass, and the render and collider managers drop all of their removed renderers
+ * and colliders in one pass each, so removing many objects at once takes linear time.
+ * Called by the game at the end of each frame.
+ */
+void GameObject::FlushDestroyed()
+{
+    while (!compaction_queue.empty()) {
+        // destroying objects may remove more, which are handled on the next pass
+        std::vector<ObjectHandle> queue;
+        queue.swap(compaction_queue);
+
+        // flag the whole tree under each removed component, so the managers can find them
+        for (auto& h : queue) {
+            GameObject *parent = h.Get();
+            if (parent == nullptr) continue;
+            for (auto& component : parent->components) {
+                if (component->pending_destroy) component->mark_pending();
+            }
+        }
+        renderManager.RemovePending();
+        colliderManager.RemovePending();
+
+        for (auto& h : queue) {
+            GameObject *parent = h.Get();
+            if (parent != nullptr) parent->compact_components();
         }
     }
 }
 
+/* Adds a new component to the list of every type it matches that has been looked up. */
+void GameObject::index_component(const std::shared_ptr<GameObject>& component)
+{
+    for (auto& entry : type_index) {
+        if (entry.second.matches(component.get())) entry.second.list.push_back(component);
+    }
+}
+
+/*
+ * Records the object's parent and what its type redefines, then adds it and any components it
+ * already has to its parent's update list. Called by `AddComponent`.
+ */
+void GameObject::attach(GameObject *newParent, unsigned int typePhases, bool customTraversal)
+{
+    // keep the position and scale the object was created with, now relative to its parent
+    Vector2 position = Position(), size = Scale();
+    parent = newParent;
+    SetPosition(position);
+    SetScale(size);
+    invalidate_enabled();
+    parent->add_render_layers(render_layers);
+
+    phases = typePhases;
+    custom_traversal = customTraversal;
+    traversed = newParent->custom_traversal || newParent->traversed;
+    join_update_list(newParent->update_list);
+}
+
+/* Puts the object and its components in an update list */
+void GameObject::join_update_list(UpdateList *list)
+{
+    update_list = list;
+    if (list == nullptr) return;
+    if (listed_phases() != 0) list->Add(this);
+    for (auto& component : components) {
+        component->traversed = custom_traversal || traversed;
+        component->join_update_list(list);
+    }
+}
+
+/*
+ * The update phases the object is in. Objects whose parents update their own components are
+ * left out of the `Update` and `ParallelUpdate` phases, since their parents call those instead.
+ */
+unsigned int GameObject::listed_phases() const
+{
+    unsigned int listed = phases;
+    if (custom_traversal) listed |= PHASE_BIT(PHASE_UPDATE);
+    if (traversed) listed &= ~(PHASE_BIT(PHASE_UPDATE) | PHASE_BIT(PHASE_PARALLEL_UPDATE));
+    return listed;
+}
+
+/* Forgets the cached enabled state of the object and everything under it, after its parent changes */
+void GameObject::invalidate_enabled()
+{
+    enabled_cache = 0;
+    for (auto& component : components) component->invalidate_enabled();
+}
+
+/* Records that something under the object draws on the given render layers, for the object and its parents */
+void GameObject::add_render_layers(unsigned int mask)
+{
+    // parents always have every layer their components have, so stop at the first that already does
+    for (GameObject *object = this; object != nullptr; object = object->parent) {
+        if ((object->render_layers & mask) == mask) return;
+        object->render_layers |= mask;
+    }
+}
+
+/* Sets the update list the object's components are added to. Used by scenes to hold their own list. */
+void GameObject::SetUpdateList(UpdateList *list) { update_list = list; }
+
+/* Flags the object and everything under it as being destroyed */
+void GameObject::mark_pending()
+{
+    pending_destroy = true;
+    enabled_cache = 0;
+    for (auto& component : components) component->mark_pending();
+}
+
+/*
+ * Called when the object turns on or off, or is removed. Every object's cached `Enabled()` is now
+ * out of date, and is worked out again when next read.
+ */
+void GameObject::active_changed()
+{
+    enabled_epoch++;
+    // update lists and managers only revisit the objects under this one
+    toggled_roots.push_back(handle);
+    // renderers and sprites under the object are hidden with it, so cached layers must be redrawn
+    for (int i = 0; i < RENDER_LAYERS; i++) {
+        if (render_layers & (1u<<i)) renderManager.DirtyLayer(i);
+    }
+}
+
+/*
+ * Brings update lists, the collider manager and the render manager up to date with every object
+ * turned on, off or removed since the last call. Only the objects under those are visited, skipping
+ * any turned off by themselves, since nothing under them changed. Called before each update phase,
+ * collision check and render, so does nothing when nothing has been toggled.
+ */
+void GameObject::RefreshToggled()
+{
+    while (!toggled_roots.empty()) {
+        // refreshing can end collisions, whose callbacks may toggle more objects
+        std::vector<ObjectHandle> roots;
+        roots.swap(toggled_roots);
+        for (auto& h : roots) {
+            GameObject *root = h.Get();
+            if (root != nullptr) root->refresh_subtree(true);
+        }
+    }
+}
+
+/* Refreshes the object and everything under it. Objects turned off by themselves are skipped, unless they are the root. */
+void GameObject::refresh_subtree(bool root)
+{
+    if (!root && !enabled) return;
+    refresh_active();
+    for (int i = 0; i < components.size(); i++) components[i]->refresh_subtree(false);
+}
+
+/*
+ * Sets the object aside in its update list if it is inactive, or puts it back if it is active again.
+ * Redefined by components that other lists hold, so they can move themselves too.
+ */
+void GameObject::refresh_active()
+{
+    if (update_list != nullptr) update_list->Refresh(this);
+}
+
+/* Erases and destroys every pending component in one pass, keeping the rest in order. */
+void GameObject::compact_components()
+{
+    compaction_queued = false;
+
+    std::vector<std::shared_ptr<GameObject>> removed;
+    auto end = std::remove_if(components.begin(), components.end(), [&removed](const std::shared_ptr<GameObject>& component) {
+        if (!component->pending_destroy) return false;
+        removed.push_back(component);
+        return true;
+    });
+    components.erase(end, components.end());
+
+    for (auto& entry : type_index) {
+        auto& list = entry.second.list;
+        list.erase(std::remove_if(list.begin(), list.end(), [](const std::shared_ptr<GameObject>& component) {
+            return component->pending_destroy;
+        }), list.end());
+    }
+
+    for (auto& component : removed) component->Destroy();
+}
+
 /* Get all the objects components */
 std::vector<std::shared_ptr<GameObject>> GameObject::GetAllComponents() const {
     return components;
@@ -115,14 +442,130 @@ void GameObject::OnCollisionStay(Collision collision)
 }
 
 /* Behaviour for breaking collision with an object. Redefine in subclass definitions */
-void GameObject::OnCollisionExit(std::shared_ptr<GameObject> other)
+void GameObject::OnCollisionExit(ObjectHandle other)
 {
 
 }
 
-/* Whether or not the object is currently active. */
-bool GameObject::Enabled() const { return enabled; }
-/* The current position of the object. */
-Vector2 GameObject::Position() const { return pos; }
+/* A non-owning reference to the object, which becomes null once the object is destroyed. */
+ObjectHandle GameObject::Handle() const { return handle; }
+/* The object this is a component of, or `nullptr` if it isn't a component. */
+GameObject *GameObject::Parent() const { return parent; }
+/* Whether the object has been removed, and will be destroyed at the end of the frame. */
+bool GameObject::PendingDestroy() const { return pending_destroy; }
+/*
+ * Whether or not the object is currently active: it and all of its parents are enabled.
+ * Objects waiting to be destroyed are inactive. The result is cached until any object is
+ * turned on or off, so reading it again is cheap. Safe to call from several threads at once.
+ */
+bool GameObject::Enabled() const
+{
+    std::uint64_t epoch = enabled_epoch.load(std::memory_order_relaxed);
+    std::uint64_t cache = enabled_cache.load(std::memory_order_relaxed);
+    if ((cache >> 1) == epoch) return cache & 1;
+
+    bool active = enabled && !pending_destroy && (parent == nullptr || parent->Enabled());
+    enabled_cache.store((epoch << 1) | active, std::memory_order_relaxed);
+    return active;
+}
+/* Whether the object itself is enabled, ignoring its parents. */
+bool GameObject::EnabledSelf() const { return enabled; }
+/* The current position of the object in game space. */
+Vector2 GameObject::Position() const
+{
+    resolve_transform();
+    return world_pos;
+}
 /* The current scale, or size, of the object. */
-Vector2 GameObject::Scale() const { return scale; }
\ No newline at end of file
+Vector2 GameObject::Scale() const
+{
+    resolve_transform();
+    return world_scale;
+}
+/* The object's position relative to its parent's. */
+Vector2 GameObject::LocalPosition() const { return local_pos; }
+/* The object's scale as a multiple of its parent's. */
+Vector2 GameObject::LocalScale() const { return local_scale; }
+/* 
+ * Counter that changes whenever the object's position or scale changes, including when its parent moves.
+ * Compare against a previously read value to check if the object has moved.
+ */
+unsigned int GameObject::TransformVersion() const
+{
+    resolve_transform();
+    return world_version;
+}
+
+/* The arena components added to the object are allocated from. `nullptr` if they use the heap. */
+std::shared_ptr<PoolArena> GameObject::Arena() const { return arena; }
+
+/*
+ * Sets the arena that components added to the object from now on are allocated from.
+ * Components pass their arena on to their own components.
+ *
+ * \param newArena The arena to use, or `nullptr` to allocate on the heap.
+ */
+void GameObject::SetArena(std::shared_ptr<PoolArena> newArena) { arena = newArena; }
+
+/*
+ * Draws a texture centred on the object, sized to its scale, without adding a component.
+ * The sprite is stored by value in the render manager, and removed when the object is destroyed.
+ * 
+ * \param texture The texture being rendered.
+ * \param z Value used to determine which order objects are rendered in.
+ * \param layer The render layer the sprite is drawn on.
+ * \param renderRelative Whether or not the sprite is rendered relative to cameras, or on the window directly.
+ * 
+ * \returns A handle used to change the sprite through the render manager.
+ */
+SpriteHandle GameObject::AttachSprite(std::shared_ptr<LTexture> texture, int z, int layer, bool renderRelative)
+{
+    SpriteHandle handle = renderManager.AddSprite(texture, this, z, layer, renderRelative);
+    sprites.push_back(handle);
+    return handle;
+}
+
+/* Removes a sprite attached to the object. Does nothing if the sprite isn't attached. */
+void GameObject::DetachSprite(SpriteHandle handle)
+{
+    for (auto it=sprites.begin(), e=sprites.end(); it!=e; it++) {
+        if (*it == handle) {
+            renderManager.RemoveSprite(handle);
+            sprites.erase(it);
+            break;
+        }
+    }
+}
+
+/* Handles of all sprites attached to the object. */
+const std::vector<SpriteHandle>& GameObject::Sprites() const { return sprites; }
+
+/*
+ * Works out the object's world position and scale, if it or any of its parents have changed since they
+ * were last worked out. Parents are always resolved first, so reading an object costs its depth in the tree.
+ * Safe to call from several threads at once, as long as no transforms are being set at the same time.
+ */
+void GameObject::resolve_transform() const
+{
+    unsigned int parent_version = 0;
+    if (parent != nullptr) {
+        parent->resolve_transform();
+        parent_version = parent->world_version.load(std::memory_order_acquire);
+    }
+    if (resolved_parent.load(std::memory_order_acquire) == parent_version && resolved_local.load(std::memory_order_acquire) == local_version) return;
+
+    std::lock_guard<std::mutex> lock(transform_locks[(reinterpret_cast<std::uintptr_t>(this) / sizeof(void*)) % TRANSFORM_LOCKS]);
+    // another thread may have got here first
+    if (resolved_parent.load(std::memory_order_relaxed) == parent_version && resolved_local.load(std::memory_order_relaxed) == local_version) return;
+
+    if (parent != nullptr) {
+        world_pos = parent->world_pos + local_pos;
+        world_scale = parent->world_scale & local_scale;
+    } else {
+        world_pos = local_pos;
+        world_scale = local_scale;
+    }
+    world_version.fetch_add(1, std::memory_order_release);
+    resolved_local.store(local_version, std::memory_order_release);
+    resolved_parent.store(parent_version, std::memory_order_release);
+}
@@ -1,17 +1,31 @@
 #pragma once 
 
 #include "../Math/VectorMath.hpp"
+#include "Renderer/Sprite.hpp"
+#include "TypeId.hpp"
+#include "PoolArena.hpp"
+#include "ObjectHandle.hpp"
+#include "UpdateList.hpp"
+#include "../JobSystem.hpp"
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <typeinfo>
 #include <type_traits>
 #include <utility>
+#include <unordered_map>
 
 using namespace Math;
 
 // forwards declaration
 struct Collision;
+class TextureRenderer;
+
+/* The class a member function pointer type belongs to */
+template <class M> struct member_class;
+template <class C, class F> struct member_class<F C::*> { typedef C type; };
 
 /* Baseplate object in game space, contains a vector of components */
 class GameObject
@@ -23,17 +37,26 @@ class GameObject
 
         virtual void Destroy();
 
+        virtual void FixedUpdate();
+        virtual void CollisionUpdate();
+        virtual void PhysicsUpdate();
         virtual void Update();
+        virtual void ParallelUpdate();
+        virtual void LateUpdate();
+        virtual void PreRender();
         virtual void UpdateComponents();
 
         virtual void SetEnabled(bool enable);
         virtual void SetPosition(Vector2 newPosition);
         virtual void SetScale(Vector2 newScale);
+        void SetLocalPosition(Vector2 newPosition);
+        void SetLocalScale(Vector2 newScale);
 
         virtual void AssignComponents(std::shared_ptr<GameObject> self);
         
         /*
          * Adds an component to theobject using the information provided.
+         * If the object has an arena, the component is allocated from it, and shares it.
          *
          * \returns A pointer to the component added.
          * 
@@ -43,92 +66,248 @@ class GameObject
         template <class T, class... Args>
         std::shared_ptr<T> AddComponent(Args&&... args)
         {
-            auto comp = std::make_shared<T>(std::forward<Args>(args)...);
+            std::shared_ptr<T> comp;
+            if (arena != nullptr) comp = std::allocate_shared<T>(PoolAllocator<T>(arena), std::forward<Args>(args)...);
+            else comp = std::make_shared<T>(std::forward<Args>(args)...);
+            comp->SetArena(arena);
+            // objects are only in the update phases their type redefines the function of
+            GameObject *base = comp.get();
+            base->attach(this, phases_of<T>(), !std::is_same<decltype(&T::UpdateComponents), void (GameObject::*)()>::value);
+            // renderers are only drawn in batches if their type doesn't redefine `Render` without `GetQuad`
+            if constexpr (std::is_base_of<TextureRenderer, T>::value) comp->batched = draws_quad<T>();
             comp->AssignComponents(comp);
             components.push_back(comp);
+            index_component(comp);
             return comp;
         }
 
         /* 
-         * Removes the specified component type from the object. 
+         * Removes the specified component type from the object. Subclasses of `T` count as `T`.
          * If the object has multiple components of the specified type,
-         * only the first one found is removed. 
+         * only the first one found is removed. The component is destroyed at the end of the frame.
          */
         template <typename T>
         void RemoveComponent()
         {
-            // iterate through each item in the components vector
-            for (auto it=components.begin(), e=components.end(); it!=e; it++) {
-                // once one mathces the specified type, erase it from the vector
-                if (typeid(**it) == typeid(T)) {
-                    components.erase(it);
-                    break;
-                }
+            std::vector<std::shared_ptr<GameObject>> scratch;
+            for (auto& component : components_of<T>(scratch)) {
+                if (component->pending_destroy) continue;
+                RemoveComponent(component);
+                return;
             }
         }
 
         /*
          * Finds a component of the specified type attatched to this object.
+         * Subclasses of `T` count as `T`.
          * 
          * \returns An `std::shared_ptr` to the component whose type matches the
          * specified type. If the object has multiple components of this type, only
-         * the first one found is returned. If no such component exists,
+         * the first one added is returned. If no such component exists,
          * `nullptr` is returned. 
          */
         template <typename T>
         std::shared_ptr<T> GetComponent()
         {
-            // iterate through all components
-            for (auto& component : components) {
-                // if a matching type is found, return it
-                if (typeid(*component) == typeid(T)) {
-                    return std::dynamic_pointer_cast<T>(component);
-                }
+            // every component in the list is known to be a T
+            std::vector<std::shared_ptr<GameObject>> scratch;
+            for (auto& component : components_of<T>(scratch)) {
+                if (!component->pending_destroy) return std::static_pointer_cast<T>(component);
             }
-            // return nullptr for failure
             return nullptr;
         }
 
         /*
          * Finds all components of the specified type attatched to this object.
+         * Subclasses of `T` count as `T`.
          *
          * \returns An `std::vector` of `std::shared_ptr`s of all components of the given
-         * type attached to this object
+         * type attached to this object, in the order they were added.
          */
         template <typename T>
         std::vector<std::shared_ptr<T>> GetComponents()
         {
+            std::vector<std::shared_ptr<GameObject>> scratch;
+            auto& list = components_of<T>(scratch);
             std::vector<std::shared_ptr<T>> res;
-            for (auto& component : components) {
-                if (typeid(*component) == typeid(T)) {
-                    res.push_back(std::dynamic_pointer_cast<T>(component));
-                }
+            res.reserve(list.size());
+            for (auto& component : list) {
+                if (!component->pending_destroy) res.push_back(std::static_pointer_cast<T>(component));
             }
             return res;
         }
 
         std::vector<std::shared_ptr<GameObject>> GetAllComponents() const;
 
-        void RemoveComponent(std::shared_ptr<GameObject> obj);
+        void RemoveComponent(ObjectHandle obj);
+
+        SpriteHandle AttachSprite(std::shared_ptr<LTexture> texture, int z = 0, int layer = 0, bool renderRelative = true);
+        void DetachSprite(SpriteHandle handle);
+        const std::vector<SpriteHandle>& Sprites() const;
 
         virtual void OnCollisionEnter(Collision collision);
         virtual void OnCollisionStay(Collision collision);
-        virtual void OnCollisionExit(std::shared_ptr<GameObject> other);
+        virtual void OnCollisionExit(ObjectHandle other);
 
+        ObjectHandle Handle() const;
+        GameObject *Parent() const;
+        bool PendingDestroy() const;
         bool Enabled() const;
+        bool EnabledSelf() const;
         Vector2 Position() const;
         Vector2 Scale() const;
+        Vector2 LocalPosition() const;
+        Vector2 LocalScale() const;
+        unsigned int TransformVersion() const;
+
+        std::shared_ptr<PoolArena> Arena() const;
+        void SetArena(std::shared_ptr<PoolArena> newArena);
+
+        static void FlushDestroyed();
+        static void RefreshToggled();
+
+    protected:
+
+        void SetUpdateList(UpdateList *list);
+
+        virtual void refresh_active();
 
     private:
 
-        /* Whether or not the obejct is enabled */
+        /* Whether or not the obejct is enabled, ignoring its parents */
         bool enabled;
+        /* 
+         * Whether the object and all its parents were enabled, in the lowest bit,
+         * and the value of the global enabled epoch when that was worked out, in the rest.
+         */
+        mutable std::atomic<std::uint64_t> enabled_cache{0};
+        /* Bitmask of the render layers drawn on by the object and everything under it. Never cleared. */
+        unsigned int render_layers = 0;
+        friend class RenderManager;
+
+        /* The object's slot in the global handle table */
+        ObjectHandle handle;
+
+        /* The object this is a component of. `nullptr` for scenes and objects not added with `AddComponent`. */
+        GameObject *parent = nullptr;
+
+        /* The update list the object and its components are in. `nullptr` if they aren't in one. */
+        UpdateList *update_list = nullptr;
+        /* The object's position in each of its update list's phases. `-1` when not in the phase. */
+        int phase_index[UPDATE_PHASES] = {-1, -1, -1, -1, -1, -1, -1};
+        /* Whether the object is in its update list's phases, rather than set aside or not added */
+        bool listed = false;
+        /* The object's position in its update list's list of disabled objects. `-1` when not in it. */
+        int parked_index = -1;
+        /* Whether the object is waiting to be put back in its update list's phases */
+        bool restore_queued = false;
+        /* When the object was added to its update list, used to keep objects in order */
+        unsigned int update_order = 0;
+        /* Bitmask of the update phases the object's type redefines the function of */
+        unsigned int phases = 0;
+        /* Whether the object's type redefines `UpdateComponents`, so updates its own components */
+        bool custom_traversal = false;
+        /* Whether a parent redefines `UpdateComponents`, so calls the object's `Update` itself */
+        bool traversed = false;
+        friend class UpdateList;
+
+        /* Whether the object is waiting to be removed from its parent at the end of the frame */
+        bool pending_destroy = false;
+        /* Whether the object is queued to have its pending components removed */
+        bool compaction_queued = false;
 
         /* Vector of all the object's components */
         std::vector<std::shared_ptr<GameObject>> components;
+        /* Arena components added to the object are allocated from. `nullptr` to use the heap. */
+        std::shared_ptr<PoolArena> arena = nullptr;
+        /* Handles of the sprites drawn on the object, stored in the render manager */
+        std::vector<SpriteHandle> sprites;
+
+        /* The components matching a single type, kept up to date as components are added and removed */
+        struct TypeIndex {
+            std::vector<std::shared_ptr<GameObject>> list;
+            /* Checks whether a component is of the type, or a subclass of it */
+            bool (*matches)(GameObject *obj);
+        };
+        /* Lists of components by type id. A type's list is built the first time the type is looked up. */
+        std::unordered_map<TypeIdValue,TypeIndex> type_index;
+
+        /*
+         * All components of type `T`, or a subclass of `T`, in the order they were added.
+         * 
+         * In a job, other jobs may be reading the object at the same time, so the first lookup
+         * of a type only finds the matching components into `scratch`, without indexing the type.
+         */
+        template <typename T>
+        const std::vector<std::shared_ptr<GameObject>>& components_of(std::vector<std::shared_ptr<GameObject>>& scratch)
+        {
+            auto it = type_index.find(TypeId<T>());
+            if (it != type_index.end()) return it->second.list;
+            if (JobSystem::InJob()) {
+                for (auto& component : components) {
+                    if (dynamic_cast<T*>(component.get()) != nullptr) scratch.push_back(component);
+                }
+                return scratch;
+            }
+
+            // first lookup of this type, so find every matching component once
+            TypeIndex& index = type_index[TypeId<T>()];
+            index.matches = [](GameObject *obj) { return dynamic_cast<T*>(obj) != nullptr; };
+            for (auto& component : components) {
+                if (index.matches(component.get())) index.list.push_back(component);
+            }
+            return index.list;
+        }
+
+        void index_component(const std::shared_ptr<GameObject>& component);
+        void mark_pending();
+        void compact_components();
+
+        void attach(GameObject *newParent, unsigned int typePhases, bool customTraversal);
+        void join_update_list(UpdateList *list);
+        unsigned int listed_phases() const;
+
+        /* Bitmask of the update phases whose function `T` redefines */
+        template <class T>
+        static unsigned int phases_of()
+        {
+            typedef void (GameObject::*Phase)();
+            unsigned int phases = 0;
+            if (!std::is_same<decltype(&T::FixedUpdate), Phase>::value) phases |= PHASE_BIT(PHASE_FIXED_UPDATE);
+            if (!std::is_same<decltype(&T::PhysicsUpdate), Phase>::value) phases |= PHASE_BIT(PHASE_PHYSICS);
+            if (!std::is_same<decltype(&T::CollisionUpdate), Phase>::value) phases |= PHASE_BIT(PHASE_COLLISION);
+            if (!std::is_same<decltype(&T::Update), Phase>::value) phases |= PHASE_BIT(PHASE_UPDATE);
+            if (!std::is_same<decltype(&T::ParallelUpdate), Phase>::value) phases |= PHASE_BIT(PHASE_PARALLEL_UPDATE);
+            if (!std::is_same<decltype(&T::LateUpdate), Phase>::value) phases |= PHASE_BIT(PHASE_LATE_UPDATE);
+            if (!std::is_same<decltype(&T::PreRender), Phase>::value) phases |= PHASE_BIT(PHASE_PRE_RENDER);
+            return phases;
+        }
+        /* Whether `T`'s `GetQuad` comes from the same class as its `Render`, or a subclass of it */
+        template <class T>
+        static bool draws_quad()
+        {
+            typedef typename member_class<decltype(&T::Render)>::type DrawnBy;
+            typedef typename member_class<decltype(&T::GetQuad)>::type QuadFrom;
+            return std::is_base_of<DrawnBy, QuadFrom>::value;
+        }
+        void invalidate_enabled();
+        void active_changed();
+        void refresh_subtree(bool root);
+        void add_render_layers(unsigned int mask);
+
+        /* The object's position, relative to its parent's. In game space for objects without a parent. */
+        Vector2 local_pos;
+        /* The object's scale, as a multiple of its parent's. The actual scale for objects without a parent. */
+        Vector2 local_scale;
+        /* Incremented whenever the local position or scale changes */
+        unsigned int local_version = 1;
+
+        /* The position and scale in game space, worked out from the parent's when read */
+        mutable Vector2 world_pos, world_scale;
+        /* Incremented whenever the world position or scale is found to have changed */
+        mutable std::atomic<unsigned int> world_version{1};
+        /* The parent's world version and the local version the world transform was last worked out from */
+        mutable std::atomic<unsigned int> resolved_parent{0}, resolved_local{0};
 
-        /* The object's position in game space */
-        Vector2 pos;
-        /* The scale, or size of the object */
-        Vector2 scale;
+        void resolve_transform() const;
 };
\ No newline at end of file
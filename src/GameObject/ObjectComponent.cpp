@@ -10,7 +10,7 @@
  * calling `obj->AddComponent(newComponent)`, so that the new component actually 
  * gets updated alongside the object
  */
-ObjectComponent::ObjectComponent(std::shared_ptr<GameObject> object, bool startEnabled)
+ObjectComponent::ObjectComponent(ObjectHandle object, bool startEnabled)
 : GameObject(Vector2_Zero, Vector2_One, startEnabled), obj(object)
 {
 
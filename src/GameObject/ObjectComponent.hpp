@@ -7,11 +7,11 @@ class ObjectComponent : public GameObject
 {
     public:
 
-        ObjectComponent(std::shared_ptr<GameObject> object, bool startEnabled = true);
+        ObjectComponent(ObjectHandle object, bool startEnabled = true);
         ~ObjectComponent();
 
         virtual void Destroy();
 
-        /* Reference to the object the component modifies */
-        std::shared_ptr<GameObject> obj;
+        /* Reference to the object the component modifies. Doesn't keep the object alive. */
+        ObjectHandle obj;
 };
\ No newline at end of file
@@ -0,0 +1,93 @@
+#include "ObjectHandle.hpp"
+#include "GameObject.hpp"
+#include "../JobSystem.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/* A slot in the object table */
+struct HandleSlot {
+    /* The object in the slot, or `nullptr` if it is free */
+    GameObject *object = nullptr;
+    /* Changed whenever the slot is freed, so old handles stop matching */
+    unsigned int generation = 0;
+};
+
+/* The global slot table. Slot 0 is never used, so a handle of 0 is always null. */
+static std::vector<HandleSlot>& handle_slots()
+{
+    static std::vector<HandleSlot> slots(1);
+    return slots;
+}
+
+/* Indices of free slots */
+static std::vector<unsigned int>& free_slots()
+{
+    static std::vector<unsigned int> slots;
+    return slots;
+}
+
+/*
+ * Stops the game if the slot table is changed from a job. Handles are resolved from jobs without
+ * locking, which is only safe while nothing adds or frees slots.
+ */
+static void require_main_thread(const char *function)
+{
+    if (!JobSystem::InJob()) return;
+    printf("ObjectHandle::%s can't be called from a job. Create and destroy objects on the main thread.\n", function);
+    fflush(stdout);
+    // other threads are still running jobs, so don't run global destructors
+    _Exit(1);
+}
+
+/* The handle of an existing object. `nullptr` gives a null handle. */
+ObjectHandle::ObjectHandle(const GameObject *object)
+{
+    if (object != nullptr) value = object->Handle().value;
+}
+
+/* The object referred to, or `nullptr` if it no longer exists */
+GameObject *ObjectHandle::Get() const
+{
+    const HandleSlot& slot = handle_slots()[value & HANDLE_INDEX_MASK];
+    if (slot.generation != (value >> HANDLE_INDEX_BITS)) return nullptr;
+    return slot.object;
+}
+
+/* Gives an object a slot in the table. Called once by each object on creation. */
+ObjectHandle ObjectHandle::Register(GameObject *object)
+{
+    require_main_thread("Register");
+    auto& slots = handle_slots();
+    unsigned int index;
+    if (!free_slots().empty()) {
+        index = free_slots().back();
+        free_slots().pop_back();
+    } else {
+        index = slots.size();
+        if (index > MAX_OBJECTS) {
+            printf("Too many game objects! The maximum is %u.\n", MAX_OBJECTS);
+            exit(1);
+        }
+        slots.emplace_back();
+    }
+
+    slots[index].object = object;
+    ObjectHandle handle;
+    handle.value = (slots[index].generation << HANDLE_INDEX_BITS) | index;
+    return handle;
+}
+
+/* Frees an object's slot, so handles to it resolve to `nullptr`. Called by each object on destruction. */
+void ObjectHandle::Unregister(ObjectHandle handle)
+{
+    unsigned int index = handle.value & HANDLE_INDEX_MASK;
+    if (index == 0 || handle.Get() == nullptr) return;
+    require_main_thread("Unregister");
+
+    HandleSlot& slot = handle_slots()[index];
+    slot.object = nullptr;
+    slot.generation = (slot.generation + 1) & (0xFFFFFFFFu >> HANDLE_INDEX_BITS);
+    free_slots().push_back(index);
+}
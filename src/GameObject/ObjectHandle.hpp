@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+/* Bits of a handle used for the slot index. The rest hold the slot's generation. */
+#define HANDLE_INDEX_BITS 20
+#define HANDLE_INDEX_MASK ((1u << HANDLE_INDEX_BITS) - 1)
+/* The most objects that can exist at once */
+#define MAX_OBJECTS HANDLE_INDEX_MASK
+
+// forwards declaration
+class GameObject;
+
+/*
+ * Non-owning 32 bit reference to a game object, made of a slot index and generation.
+ * Every object holds a slot in a global table for as long as it exists. When an object is
+ * destroyed its slot's generation changes, so handles to it resolve to `nullptr` instead of
+ * dangling. Copying a handle is just copying an integer.
+ *
+ * \note Handles can be resolved from any thread, but objects, and so their slots, must only be
+ * created and destroyed on the main thread, never from a job. Doing so stops the game with an error.
+ * \note Generations wrap around after 4096 objects have used the same slot, so a handle kept
+ * for that long could resolve to a newer object.
+ */
+class ObjectHandle
+{
+    public:
+
+        ObjectHandle() = default;
+        ObjectHandle(std::nullptr_t) {}
+        ObjectHandle(const GameObject *object);
+        template <typename T>
+        ObjectHandle(const std::shared_ptr<T>& object) : ObjectHandle(static_cast<const GameObject*>(object.get())) {}
+
+        GameObject *Get() const;
+        /* The object, if it still exists and is of type `T`. `nullptr` otherwise. */
+        template <typename T>
+        T *As() const { return dynamic_cast<T*>(Get()); }
+
+        GameObject *operator->() const { return Get(); }
+        GameObject& operator*() const { return *Get(); }
+        explicit operator bool() const { return Get() != nullptr; }
+
+        bool operator==(const ObjectHandle& other) const { return value == other.value; }
+        bool operator!=(const ObjectHandle& other) const { return value != other.value; }
+        /* A handle equals `nullptr` if it doesn't refer to an existing object */
+        bool operator==(std::nullptr_t) const { return Get() == nullptr; }
+        bool operator!=(std::nullptr_t) const { return Get() != nullptr; }
+
+        /* The handle packed into an integer. `0` for a null handle. */
+        unsigned int Value() const { return value; }
+
+    private:
+
+        unsigned int value = 0;
+
+        friend class GameObject;
+        static ObjectHandle Register(GameObject *object);
+        static void Unregister(ObjectHandle handle);
+};
+
+namespace std {
+    template <>
+    struct hash<ObjectHandle> {
+        size_t operator()(const ObjectHandle& handle) const { return hash<unsigned int>()(handle.Value()); }
+    };
+}
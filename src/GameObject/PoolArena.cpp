@@ -0,0 +1,138 @@
+#include "PoolArena.hpp"
+#include "../JobSystem.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Stops the game if an arena is used from a job. Free lists and slabs aren't locked, so objects
+ * must be created, and their last `shared_ptr` dropped, on the main thread.
+ */
+static void require_main_thread(const char *function)
+{
+    if (!JobSystem::InJob()) return;
+    printf("PoolArena::%s can't be called from a job. Create and release objects on the main thread.\n", function);
+    fflush(stdout);
+    // other threads are still running jobs, so don't run global destructors
+    _Exit(1);
+}
+
+PoolArena::PoolArena()
+{
+    for (auto& list : free_lists) list = nullptr;
+}
+
+PoolArena::~PoolArena()
+{
+    free_slabs();
+}
+
+/*
+ * Allocates a block of memory, reusing a freed block of the same size class if there is one.
+ *
+ * \param size The number of bytes needed.
+ * \param align The alignment needed. Blocks are aligned to `POOL_SIZE_STEP` bytes.
+ *
+ * \returns The block allocated.
+ */
+void *PoolArena::Allocate(std::size_t size, std::size_t align)
+{
+    require_main_thread("Allocate");
+    // too big or too aligned for a size class
+    if (!pooled(size, align)) {
+        stats.largeAllocations++;
+        return ::operator new(size, std::align_val_t(align));
+    }
+
+    std::size_t block_size = (size + POOL_SIZE_STEP-1) / POOL_SIZE_STEP * POOL_SIZE_STEP;
+    int size_class = block_size/POOL_SIZE_STEP - 1;
+
+    void *block;
+    if (free_lists[size_class] != nullptr) {
+        FreeBlock *free_block = free_lists[size_class];
+        free_lists[size_class] = free_block->next;
+        stats.freeBlocks--;
+        block = free_block;
+    }
+    else {
+        // start a new slab when the current one is full. the rest of the old slab is wasted.
+        if (bump == nullptr || (std::size_t)(bump_end-bump) < block_size) {
+            bump = static_cast<unsigned char*>(::operator new(POOL_SLAB_SIZE, std::align_val_t(POOL_SIZE_STEP)));
+            bump_end = bump + POOL_SLAB_SIZE;
+            slabs.push_back(bump);
+            stats.slabs++;
+            stats.reservedBytes += POOL_SLAB_SIZE;
+        }
+        block = bump;
+        bump += block_size;
+    }
+
+    stats.liveBlocks++;
+    stats.liveBytes += block_size;
+    if (stats.liveBytes > stats.peakBytes) stats.peakBytes = stats.liveBytes;
+    return block;
+}
+
+/* Returns a block to the free list of its size class. `size` and `align` must match the allocation. */
+void PoolArena::Deallocate(void *ptr, std::size_t size, std::size_t align)
+{
+    if (ptr == nullptr) return;
+    require_main_thread("Deallocate");
+
+    if (!pooled(size, align)) {
+        stats.largeAllocations--;
+        ::operator delete(ptr, std::align_val_t(align));
+        return;
+    }
+
+    std::size_t block_size = (size + POOL_SIZE_STEP-1) / POOL_SIZE_STEP * POOL_SIZE_STEP;
+    int size_class = block_size/POOL_SIZE_STEP - 1;
+
+    FreeBlock *free_block = static_cast<FreeBlock*>(ptr);
+    free_block->next = free_lists[size_class];
+    free_lists[size_class] = free_block;
+    stats.freeBlocks++;
+    stats.liveBlocks--;
+    stats.liveBytes -= block_size;
+
+    if (release_pending && stats.liveBlocks == 0) free_slabs();
+}
+
+/*
+ * Gives all slab memory back to the heap at once, rather than block by block. This only saves
+ * freeing each block: the objects in them must already have been destroyed, each running its
+ * destructor. If blocks are still in use, the slabs are freed when the last one is returned instead.
+ * The arena can keep being used afterwards.
+ */
+void PoolArena::Release()
+{
+    require_main_thread("Release");
+    if (stats.liveBlocks == 0) free_slabs();
+    else release_pending = true;
+}
+
+PoolStats PoolArena::Stats() const { return stats; }
+
+
+/* ==========  HELPER FUNCTIONS  ========== */
+
+/* Whether an allocation is served from a size class, rather than the heap */
+bool PoolArena::pooled(std::size_t size, std::size_t align)
+{
+    return size <= POOL_MAX_BLOCK && align <= POOL_SIZE_STEP;
+}
+
+/* Frees every slab, and forgets every free block */
+void PoolArena::free_slabs()
+{
+    for (auto slab : slabs) ::operator delete(slab, std::align_val_t(POOL_SIZE_STEP));
+    slabs.clear();
+    for (auto& list : free_lists) list = nullptr;
+    bump = bump_end = nullptr;
+    release_pending = false;
+
+    stats.freeBlocks = 0;
+    stats.slabs = 0;
+    stats.reservedBytes = 0;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/* Block sizes handed out by pool arenas are multiples of this */
+#define POOL_SIZE_STEP 16
+/* Largest block served from a size class. Bigger allocations go straight to the heap. */
+#define POOL_MAX_BLOCK 1024
+/* Size of the slabs blocks are carved from */
+#define POOL_SLAB_SIZE 65536
+
+/* Occupancy of a pool arena */
+struct PoolStats {
+    /* Blocks handed out and not yet returned */
+    std::size_t liveBlocks = 0;
+    /* Bytes in live blocks, rounded up to their size class */
+    std::size_t liveBytes = 0;
+    /* The most bytes live at once */
+    std::size_t peakBytes = 0;
+    /* Returned blocks waiting on free lists to be reused */
+    std::size_t freeBlocks = 0;
+    /* Slabs held by the arena */
+    std::size_t slabs = 0;
+    /* Total bytes of slab memory held by the arena */
+    std::size_t reservedBytes = 0;
+    /* Live allocations too large for a size class, which were made on the heap */
+    std::size_t largeAllocations = 0;
+};
+
+/*
+ * Allocator for many small objects of mixed sizes. Memory is taken from the heap in large slabs,
+ * then split into blocks by size class. Freed blocks go on a free list for their size class, and
+ * are reused by the next allocation of that size, so spawning and despawning objects doesn't touch
+ * the heap.
+ *
+ * \warning Not thread safe. Only allocate game objects, and drop the last reference to them, on the
+ * main thread. Using an arena from a job stops the game with an error.
+ */
+class PoolArena
+{
+    public:
+
+        PoolArena();
+        ~PoolArena();
+
+        void *Allocate(std::size_t size, std::size_t align);
+        void Deallocate(void *ptr, std::size_t size, std::size_t align);
+
+        void Release();
+
+        PoolStats Stats() const;
+
+    private:
+
+        /* A freed block, linked to the next free block of the same size class */
+        struct FreeBlock {
+            FreeBlock *next;
+        };
+        FreeBlock *free_lists[POOL_MAX_BLOCK / POOL_SIZE_STEP];
+
+        /* All slabs, freed together when the arena is released */
+        std::vector<unsigned char*> slabs;
+        /* Unused space at the end of the newest slab */
+        unsigned char *bump = nullptr, *bump_end = nullptr;
+
+        /* Whether the slabs are freed as soon as the last live block is returned */
+        bool release_pending = false;
+
+        PoolStats stats;
+
+        /* ==========  HELPER FUNCTIONS  ========== */
+
+        static bool pooled(std::size_t size, std::size_t align);
+        void free_slabs();
+};
+
+/*
+ * Standard allocator that allocates from a pool arena, for use with `std::allocate_shared`.
+ * Holds a reference to the arena, so the arena lives until everything allocated from it is freed.
+ */
+template <typename T>
+struct PoolAllocator {
+    typedef T value_type;
+
+    std::shared_ptr<PoolArena> arena;
+
+    PoolAllocator(std::shared_ptr<PoolArena> arena) : arena(arena) {}
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) : arena(other.arena) {}
+
+    T *allocate(std::size_t n) { return static_cast<T*>(arena->Allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T *ptr, std::size_t n) { arena->Deallocate(ptr, n * sizeof(T), alignof(T)); }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const { return arena != other.arena; }
+};
@@ -0,0 +1,95 @@
+#include "AnimationClip.hpp"
+#include <algorithm>
+#include <cmath>
+
+/*
+ * Animation clip made of regions of a sprite sheet.
+ *
+ * \param sheet The texture containing every frame.
+ * \param rects The region of the sheet shown by each frame, in order.
+ * \param durations How long each frame is shown (in seconds). If fewer durations than 
+ * rects are given, the last duration is used for the remaining frames.
+ */
+AnimationClip::AnimationClip(std::shared_ptr<LTexture> sheet, std::vector<SDL_Rect> rects, std::vector<float> durations)
+: textures({sheet})
+{
+    float t = 0.0f;
+    for (size_t i=0; i<rects.size(); i++) {
+        if (!durations.empty()) t += durations[std::min(i, durations.size()-1)];
+        frames.push_back({0, rects[i], t});
+    }
+    duration = t;
+}
+
+/*
+ * Animation clip made from a sprite sheet laid out as a grid of equally sized frames,
+ * read left to right, top to bottom. Each frame is shown for an equal amount of time.
+ *
+ * \param sheet The texture containing every frame.
+ * \param columns, rows The number of frames across and down the sheet.
+ * \param frameCount The number of frames used. Set to `-1` to use every cell of the grid.
+ * \param duration The length of a full animation cycle (in seconds).
+ */
+AnimationClip::AnimationClip(std::shared_ptr<LTexture> sheet, int columns, int rows, int frameCount, float duration)
+: textures({sheet}), duration(duration)
+{
+    if (columns<=0 || rows<=0) return;
+    int n = (frameCount<0)? columns*rows : std::min(frameCount, columns*rows);
+    int w = (sheet==nullptr)? 0 : sheet->getWidth()/columns, 
+        h = (sheet==nullptr)? 0 : sheet->getHeight()/rows;
+    for (int i=0; i<n; i++) {
+        SDL_Rect rect = {(i%columns)*w, (i/columns)*h, w, h};
+        frames.push_back({0, rect, duration*float(i+1)/float(n)});
+    }
+}
+
+/*
+ * Animation clip cycling through separate textures, each shown for an equal amount of time.
+ *
+ * \param textures The images to cycle through.
+ * \param duration The length of a full animation cycle (in seconds).
+ */
+AnimationClip::AnimationClip(std::vector<std::shared_ptr<LTexture>> textures, float duration)
+: textures(textures), duration(duration)
+{
+    int n = textures.size();
+    for (int i=0; i<n; i++) {
+        frames.push_back({i, {0,0,0,0}, duration*float(i+1)/float(n)});
+    }
+}
+
+AnimationClip::~AnimationClip()
+{
+    frames.clear();
+    textures.clear();
+}
+
+/*
+ * Finds the frame shown at a time in the animation. Times past the end of the 
+ * animation loop into later cycles.
+ *
+ * \returns The index of the frame. `-1` if the clip has no frames.
+ */
+int AnimationClip::FrameAt(float time) const
+{
+    if (frames.empty()) return -1;
+    if (duration <= 0.0f) return 0;
+
+    // loop into the first cycle
+    time = std::fmod(time, duration);
+    if (time < 0.0f) time += duration;
+
+    // first frame that ends after the time
+    auto it = std::upper_bound(frames.begin(), frames.end(), time, 
+        [](float t, const AnimationFrame& frame) { return t < frame.end; });
+    return (it==frames.end())? frames.size()-1 : it-frames.begin();
+}
+
+/* The frame at the given index. */
+const AnimationFrame& AnimationClip::Frame(int index) const { return frames[index]; }
+/* The texture shown by the frame at the given index. */
+LTexture* AnimationClip::FrameTexture(int index) const { return textures[frames[index].texture].get(); }
+/* The number of frames in the clip. */
+int AnimationClip::FrameCount() const { return frames.size(); }
+/* The length of a full animation cycle (in seconds). */
+float AnimationClip::Duration() const { return duration; }
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "../../sdl/LTexture.hpp"
+
+#include <memory>
+#include <vector>
+
+/* A single frame of an animation clip */
+struct AnimationFrame {
+    /* Index of the frame's texture in the clip's textures */
+    int texture;
+    /* The region of the texture shown. A width or height of 0 shows the whole texture. */
+    SDL_Rect clip;
+    /* Time into the animation that the frame ends (in seconds) */
+    float end;
+};
+
+/*
+ * Immutable set of animation frames, that can be shared between any number of `AnimationRenderer`s.
+ * Frames are usually regions of a single sprite sheet, but may also be separate textures.
+ */
+class AnimationClip
+{
+    public:
+
+        AnimationClip(std::shared_ptr<LTexture> sheet, std::vector<SDL_Rect> rects, std::vector<float> durations);
+        AnimationClip(std::shared_ptr<LTexture> sheet, int columns, int rows, int frameCount, float duration);
+        AnimationClip(std::vector<std::shared_ptr<LTexture>> textures, float duration);
+        ~AnimationClip();
+
+        int FrameAt(float time) const;
+        const AnimationFrame& Frame(int index) const;
+        LTexture* FrameTexture(int index) const;
+
+        int FrameCount() const;
+        float Duration() const;
+
+    private:
+
+        /* Textures shown by the frames. Only one for sprite sheets */
+        std::vector<std::shared_ptr<LTexture>> textures;
+        /* Every frame, in order */
+        std::vector<AnimationFrame> frames;
+        /* The length of a full animation cycle (in seconds) */
+        float duration = 0.0f;
+};
@@ -1,25 +1,45 @@
 #include "AnimationRenderer.hpp"
 #include "../../TimeTracker.hpp"
 
+/*
+ * Texture renderer that plays an animation clip. The current frame is found from the 
+ * game clock whenever it is rendered, so the renderer does no work while updating.
+ * 
+ * \param obj The game object the component is attached to 
+ * \param clip The animation to play. May be shared between any number of renderers.
+ * \param z Value used to determine which order objects are rendered in.
+ * \param startPlaying Whether or not the animation starts playing on creation.
+ * \param renderRelative Whether or not the object is rendered relative to cameras, or on the window directly.
+ * \param startEnabled Whether or not the component is active on creation. `true` by default.
+ */
+AnimationRenderer::AnimationRenderer(ObjectHandle obj, std::shared_ptr<const AnimationClip> clip, int z, bool startPlaying, bool renderRelative, bool startEnabled)
+: TextureRenderer(obj, nullptr, z, renderRelative, startEnabled),
+  clip(clip), start_time(gTime.Time()), playing(startPlaying)
+{
+
+}
+
 /*
  * Texture renderer that cycles through a vector of textures in an animation.
  *
  * \note Animation images will be cycled such that an equal amount of time is passed 
  * between each animation frame.
  * 
+ * \note This creates a clip used only by this renderer. To share frames between
+ * many renderers, create one `AnimationClip` and pass it to each renderer instead.
+ * 
  * \param obj The game object the component is attached to 
  * \param frames A vector of the images to cycle through.
  * \param duration The duration of a full animation cycle (in seconds). 
  * \param z Value used to determine which order objects are rendered in.
+ * \param startPlaying Whether or not the animation starts playing on creation.
  * \param renderRelative Whether or not the object is rendered relative to cameras, or on the window directly.
  * \param startEnabled Whether or not the component is active on creation. `true` by default.
  */
-AnimationRenderer::AnimationRenderer(std::shared_ptr<GameObject> obj, std::vector<std::shared_ptr<LTexture>> frames, float duration, int z, bool startPlaying, bool renderRelative, bool startEnabled)
-: TextureRenderer(obj, nullptr, z, renderRelative, startEnabled),
-  frames(frames), len(duration), playing(startPlaying)
+AnimationRenderer::AnimationRenderer(ObjectHandle obj, std::vector<std::shared_ptr<LTexture>> frames, float duration, int z, bool startPlaying, bool renderRelative, bool startEnabled)
+: AnimationRenderer(obj, std::make_shared<AnimationClip>(frames, duration), z, startPlaying, renderRelative, startEnabled)
 {
-    // find the time to elapse between each animation frame
-    timer=anim_delay = len/float(frames.size()-1);
+
 }
 
 AnimationRenderer::~AnimationRenderer()
@@ -30,36 +50,64 @@ AnimationRenderer::~AnimationRenderer()
 void AnimationRenderer::Destroy()
 {
     TextureRenderer::Destroy();
-    frames.clear();
+    clip = nullptr;
 }
 
 /*
- * Loops through animation frames when a time interval is surpassed, as long as the
- * animation is currently playing.
- * 
- * Also performs regular TextureRenderer update behaviour. 
+ * Updates the renderer's rect, and marks the renderer as changed whenever a new frame is shown,
+ * or the frame's texture changes, such as its colour or alpha.
  */
-void AnimationRenderer::Update()
+void AnimationRenderer::Prepare()
 {
-    // update normally first, then decrement timer
-    TextureRenderer::Update();
-    if (playing) timer -= gTime.deltaTime();
-
-    // proceed to next frame, and reset timer
-    if (timer <= 0.0f) {
-        // when the end of the vector is reached, go back to beginning
-        if (++idx>=frames.size()) idx = 0;
-        timer = anim_delay;
+    TextureRenderer::Prepare();
+
+    int frame = CurrentFrame();
+    // the frame's texture may not have been loaded
+    LTexture *frame_texture = (frame < 0)? nullptr : clip->FrameTexture(frame);
+    unsigned int version = (frame_texture == nullptr)? 0 : frame_texture->getVersion();
+    if (frame != prepared_frame || clip.get() != prepared_clip || version != prepared_version) {
+        prepared_frame = frame;
+        prepared_clip = clip.get();
+        prepared_version = version;
+        MarkDirty();
     }
+}
 
-    // set texture from vector
-    texture = frames[idx];
+/* Renders the animation's current frame relative to a camera. */
+void AnimationRenderer::Render(Camera *camera)
+{
+    int frame = CurrentFrame();
+    if (frame < 0) return;
+    LTexture *frame_texture = clip->FrameTexture(frame);
+    if (frame_texture == nullptr) return;
+
+    SDL_Rect rend_rect;
+    // outside of camera view, don't render
+    if (!get_render_rect(camera, &rend_rect)) return;
+
+    // render the frame's region of its texture
+    const AnimationFrame& f = clip->Frame(frame);
+    SDL_Rect src = f.clip;
+    frame_texture->render(&rend_rect, (src.w>0 && src.h>0)? &src : NULL);
+}
+
+/* Describes the current frame as a single quad, so cameras can draw it in a batch. */
+bool AnimationRenderer::GetQuad(RenderQuad *quad)
+{
+    int frame = CurrentFrame();
+    if (frame < 0) {
+        quad->texture = nullptr;
+        return true;
+    }
+    quad->texture = clip->FrameTexture(frame);
+    quad->clip = clip->Frame(frame).clip;
+    return true;
 }
 
 /* Resets the animation from beginning. */
 void AnimationRenderer::Reset() {
-    idx = 0;
-    timer = anim_delay;
+    start_time = gTime.Time();
+    paused_time = 0.0f;
 }
 
 /*
@@ -73,26 +121,57 @@ void AnimationRenderer::Reset() {
 void AnimationRenderer::goToTime(float time)
 {
     if (time<0.0f) return;
-    // bootleg modulo
-    if (time>len) time -= int(time/len)*len;
-    // get time as interpolator and go to corresponding index
-    idx = int((time/len)*frames.size());
-    // find remainder for timer
-    timer = time - (anim_delay*(float)idx);
+    if (playing) start_time = gTime.Time() - (time/speed);
+    else paused_time = time;
+}
+
+/* The time into the animation (in seconds). May be greater than the duration after looping. */
+float AnimationRenderer::CurrentTime() const
+{
+    if (!playing) return paused_time;
+    return float(gTime.Time() - start_time) * speed;
+}
+
+/* The index of the clip frame currently shown. `-1` if there is no clip, or it has no frames. */
+int AnimationRenderer::CurrentFrame() const
+{
+    if (clip == nullptr) return -1;
+    return clip->FrameAt(CurrentTime());
+}
+
+/* The animation clip being played. */
+std::shared_ptr<const AnimationClip> AnimationRenderer::Clip() const { return clip; }
+/* Switch to playing a different clip, from its beginning. */
+void AnimationRenderer::SetClip(std::shared_ptr<const AnimationClip> newClip) 
+{
+    clip = newClip;
+    speed = 1.0f;
+    Reset();
 }
 
 /* The length of the animation (in seconds) */
-float AnimationRenderer::Duration() const { return len; }
-/* Set the length of the animation (in seconds) */
+float AnimationRenderer::Duration() const { 
+    return (clip==nullptr)? 0.0f : clip->Duration()/speed;
+}
+/* Set the length of the animation (in seconds). Plays the clip faster or slower, restarting from the beginning. */
 void AnimationRenderer::SetDuration(float duration) { 
-    len = duration;
-    timer=anim_delay = len/float(frames.size()-1);
-    idx = 0;
+    if (clip == nullptr || duration <= 0.0f) return;
+    speed = clip->Duration()/duration;
+    Reset();
 }
 
 /* Whether or not the animation is currently progressing. */
 bool AnimationRenderer::Playing() const { return playing; }
 /* Make the animation progress. */
-void AnimationRenderer::Play() { playing = true; }
+void AnimationRenderer::Play() { 
+    if (playing) return;
+    // continue from where the animation was paused
+    start_time = gTime.Time() - (paused_time/speed);
+    playing = true; 
+}
 /* Make the animation stop progressing. */
-void AnimationRenderer::Pause() { playing = false; }
\ No newline at end of file
+void AnimationRenderer::Pause() { 
+    if (!playing) return;
+    paused_time = CurrentTime();
+    playing = false; 
+}
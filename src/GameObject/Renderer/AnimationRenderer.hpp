@@ -1,22 +1,31 @@
 #pragma once
 
 #include "TextureRenderer.hpp"
+#include "AnimationClip.hpp"
 
-/* Texture renderer that cycles through a vector of textures in an animation. */
+/* Texture renderer that cycles through the frames of an animation clip. */
 class AnimationRenderer : public TextureRenderer
 {
     public:
 
-        AnimationRenderer(std::shared_ptr<GameObject> obj, std::vector<std::shared_ptr<LTexture>> frames, float duration, int z = 0, bool startPlaying = true, bool renderRelative = true, bool startEnabled = true);
+        AnimationRenderer(ObjectHandle obj, std::shared_ptr<const AnimationClip> clip, int z = 0, bool startPlaying = true, bool renderRelative = true, bool startEnabled = true);
+        AnimationRenderer(ObjectHandle obj, std::vector<std::shared_ptr<LTexture>> frames, float duration, int z = 0, bool startPlaying = true, bool renderRelative = true, bool startEnabled = true);
         ~AnimationRenderer();
 
         virtual void Destroy();
 
-        virtual void Update();
+        virtual void Prepare();
+        virtual void Render(Camera *camera);
+        virtual bool GetQuad(RenderQuad *quad);
 
         void Reset();
 
         void goToTime(float time);
+        float CurrentTime() const;
+        int CurrentFrame() const;
+
+        std::shared_ptr<const AnimationClip> Clip() const;
+        void SetClip(std::shared_ptr<const AnimationClip> newClip);
 
         float Duration() const;
         void SetDuration(float duration);
@@ -27,16 +36,22 @@ class AnimationRenderer : public TextureRenderer
 
     private:
 
-        /* Set of images cycled through. */
-        std::vector<std::shared_ptr<LTexture>> frames;
-        /* The amount of time passed between each animation frame. */
-        float anim_delay, timer;
-        /* The length of the animation (in seconds) */
-        float len;
+        /* The animation being played, shared with other renderers. */
+        std::shared_ptr<const AnimationClip> clip;
+
+        /* Game time at which the animation was at its beginning (in seconds) */
+        double start_time;
+        /* Time into the animation when it was paused (in seconds) */
+        float paused_time = 0.0f;
+        /* How fast the animation plays relative to the clip's duration */
+        float speed = 1.0f;
 
         /* Whether or not the animation is currently progressing. */
         bool playing;
 
-        /* Current position in the frames vector */
-        int idx = 0;
-};
\ No newline at end of file
+        /* The clip and frame shown when the renderer was last prepared */
+        const AnimationClip *prepared_clip = nullptr;
+        int prepared_frame = -1;
+        /* The version of the frame's texture when the renderer was last prepared */
+        unsigned int prepared_version = 0;
+};
@@ -0,0 +1,204 @@
+#include "ParticleEmitter.hpp"
+#include "../Cameras/Camera.hpp"
+#include "../../GlobalWindow.hpp"
+#include "../../TimeTracker.hpp"
+#include <cstdint>
+
+/*
+ * Texture renderer that simulates and draws many small particles from the object's position.
+ * All particle storage is allocated up front, so emitting particles never allocates.
+ * 
+ * \param obj The game object the component is attached to.
+ * \param texture The texture drawn for each particle, tinted by the particle's colour. 
+ * Plain squares are drawn if `nullptr`.
+ * \param capacity The maximum number of particles alive at once.
+ * \param settings Describes how particles are created and moved.
+ * \param z Value used to determine which order objects are rendered in.
+ * \param renderRelative Whether or not the object is rendered relative to cameras, or on the window directly. `true` by default.
+ * \param startEnabled Whether or not the component is active on creation. `true` by default.
+ */
+ParticleEmitter::ParticleEmitter(ObjectHandle obj, std::shared_ptr<LTexture> texture, int capacity, ParticleSettings settings, int z, bool renderRelative, bool startEnabled)
+: TextureRenderer(obj, texture, z, renderRelative, startEnabled), settings(settings), capacity(max(capacity, 0))
+{
+    pos_x.resize(this->capacity); pos_y.resize(this->capacity);
+    vel_x.resize(this->capacity); vel_y.resize(this->capacity);
+    age.resize(this->capacity); life.resize(this->capacity);
+
+    vertex_xy.resize(this->capacity*8);
+    vertex_colours.resize(this->capacity*4);
+    vertex_uv.reserve(this->capacity*8);
+    indices.reserve(this->capacity*6);
+    for (int q=0; q<this->capacity; q++) {
+        int v = q*4;
+        vertex_uv.insert(vertex_uv.end(), {0.0f,0.0f, 1.0f,0.0f, 0.0f,1.0f, 1.0f,1.0f});
+        indices.insert(indices.end(), {v, v+1, v+2, v+2, v+1, v+3});
+    }
+
+    // seed differently for each emitter, xorshift must never be seeded with 0
+    rng_state = (Uint32)(uintptr_t)this | 1u;
+}
+
+ParticleEmitter::~ParticleEmitter()
+{
+    Destroy();
+}
+
+void ParticleEmitter::Destroy()
+{
+    TextureRenderer::Destroy();
+    count = 0;
+}
+
+/* 
+ * Emits new particles at the settings' rate, then moves and ages all live particles.
+ * Only changes the emitter, so emitters are simulated in parallel with each other.
+ */
+void ParticleEmitter::ParallelUpdate()
+{
+    float dt = gTime.deltaTime();
+
+    if (emitting) {
+        emit_accumulator += settings.rate * dt;
+        int n = (int)emit_accumulator;
+        emit_accumulator -= n;
+        Emit(n);
+    }
+
+    // particles move every frame, so cached layers must be redrawn
+    if (count > 0) MarkDirty();
+
+    // integrate every particle. each array is walked seperately with no branches,
+    // so the compiler can vectorise the loops
+    float ax = settings.acceleration.x*dt, ay = settings.acceleration.y*dt;
+    float *px = pos_x.data(), *py = pos_y.data(), *vx = vel_x.data(), *vy = vel_y.data(), *a = age.data();
+    for (int i=0; i<count; i++) vx[i] += ax;
+    for (int i=0; i<count; i++) vy[i] += ay;
+    for (int i=0; i<count; i++) px[i] += vx[i]*dt;
+    for (int i=0; i<count; i++) py[i] += vy[i]*dt;
+    for (int i=0; i<count; i++) a[i] += dt;
+
+    // remove dead particles, walking backwards so swapped in particles have already been checked
+    for (int i=count-1; i>=0; i--) {
+        if (age[i] >= life[i]) kill(i);
+    }
+}
+
+/* 
+ * Spawns particles at the object's position, using the emitter's settings.
+ * Particles past the emitter's capacity are not created.
+ */
+void ParticleEmitter::Emit(int count)
+{
+    Vector2 origin = obj->Position();
+    int n = min(count, capacity-this->count);
+    for (int j=0; j<n; j++)
+    {
+        int i = this->count++;
+        float angle = random(settings.direction, settings.spread),
+              speed = random(settings.speed, settings.speedVariance);
+        pos_x[i] = origin.x; pos_y[i] = origin.y;
+        vel_x[i] = std::cos(angle)*speed; vel_y[i] = std::sin(angle)*speed;
+        age[i] = 0.0f;
+        // keep lifetimes above 0, so the fraction of life used is always defined
+        life[i] = max(random(settings.lifetime, settings.lifetimeVariance), 0.001f);
+    }
+}
+
+/* Removes every live particle. */
+void ParticleEmitter::Clear()
+{
+    if (count > 0) MarkDirty();
+    count = 0;
+    emit_accumulator = 0.0f;
+}
+
+/*
+ * Draws every particle as a quad, in a single geometry call. 
+ * Particles outside the camera's view are left out of the vertex buffer.
+ */
+void ParticleEmitter::Render(Camera *camera)
+{
+    if (count == 0) return;
+
+    // particles without a texture are drawn as plain squares
+    if (texture == nullptr) {
+        texture = std::make_shared<LTexture>(gWindow);
+        if (!texture->solidColour({255,255,255,255})) return;
+    }
+
+    // find the transform from game space to the screen
+    ViewTransform view = camera->View(render_relative);
+    float scale = view.scale, view_w = view.width, view_h = view.height;
+    Vector2 offset = view.offset;
+    // particles fixed to the window are culled to the whole window, not just the camera's region
+    if (!render_relative) {
+        view_w = (float)gWindow->getWidth();
+        view_h = (float)gWindow->getHeight();
+    }
+
+    const SDL_Color &c0 = settings.startColour, &c1 = settings.endColour;
+    float s0 = settings.startSize, ds = settings.endSize - settings.startSize;
+    float *xy = vertex_xy.data();
+    SDL_Color *colours = vertex_colours.data();
+    int quads = 0;
+
+    for (int i=0; i<count; i++)
+    {
+        float t = age[i] / life[i];
+        float half = (s0 + ds*t) * scale * 0.5f;
+        float x = pos_x[i]*scale + offset.x, y = pos_y[i]*scale + offset.y;
+
+        // cull particles outside the view
+        if (x+half < 0.0f || y+half < 0.0f || x-half > view_w || y-half > view_h) continue;
+
+        float *v = xy + quads*8;
+        v[0] = x-half; v[1] = y-half;
+        v[2] = x+half; v[3] = y-half;
+        v[4] = x-half; v[5] = y+half;
+        v[6] = x+half; v[7] = y+half;
+
+        SDL_Color c = {
+            (Uint8)(c0.r + (c1.r-c0.r)*t), (Uint8)(c0.g + (c1.g-c0.g)*t),
+            (Uint8)(c0.b + (c1.b-c0.b)*t), (Uint8)(c0.a + (c1.a-c0.a)*t)
+        };
+        SDL_Color *vc = colours + quads*4;
+        vc[0] = c; vc[1] = c; vc[2] = c; vc[3] = c;
+        quads++;
+    }
+
+    gWindow->countCulled(count-quads);
+    texture->renderGeometry(xy, colours, vertex_uv.data(), quads*4, indices.data(), quads*6);
+}
+
+/* Returns a random number between `centre-variance` and `centre+variance`, using xorshift32. */
+float ParticleEmitter::random(float centre, float variance)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    // use the top 24 bits for a float in [0, 1)
+    float r = (rng_state >> 8) * (1.0f/16777216.0f);
+    return centre + variance*(r*2.0f - 1.0f);
+}
+
+/* Removes a particle by moving the last live particle into its place. */
+void ParticleEmitter::kill(int i)
+{
+    int last = --count;
+    pos_x[i] = pos_x[last]; pos_y[i] = pos_y[last];
+    vel_x[i] = vel_x[last]; vel_y[i] = vel_y[last];
+    age[i] = age[last]; life[i] = life[last];
+}
+
+/* Whether particles are emitted every frame at the settings' rate. */
+bool ParticleEmitter::Emitting() const { return emitting; }
+/* Set whether particles are emitted every frame at the settings' rate. `Emit` works either way. */
+void ParticleEmitter::SetEmitting(bool emit) { emitting = emit; }
+/* Describes how particles are created and moved. */
+ParticleSettings ParticleEmitter::Settings() const { return settings; }
+/* Assign how particles are created and moved. Live particles keep their current motion. */
+void ParticleEmitter::SetSettings(ParticleSettings newSettings) { settings = newSettings; }
+/* The number of live particles. */
+int ParticleEmitter::Count() const { return count; }
+/* The maximum number of live particles. */
+int ParticleEmitter::Capacity() const { return capacity; }
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "TextureRenderer.hpp"
+#include <vector>
+
+/* Describes how a `ParticleEmitter` creates and moves particles */
+struct ParticleSettings {
+    /* Particles emitted per second while emitting */
+    float rate = 100.0f;
+    /* How long each particle lives for, in seconds, plus or minus the variance */
+    float lifetime = 1.0f, lifetimeVariance = 0.0f;
+    /* The starting speed of each particle, plus or minus the variance */
+    float speed = 100.0f, speedVariance = 0.0f;
+    /* The angle particles are launched at, in radians, plus or minus the spread */
+    float direction = -PI/2.0f, spread = PI/8.0f;
+    /* Acceleration applied to every particle, such as gravity */
+    Vector2 acceleration = Vector2_Zero;
+    /* The width and height of each particle at the start and end of its life */
+    float startSize = 8.0f, endSize = 8.0f;
+    /* The colour of each particle at the start and end of its life */
+    SDL_Color startColour = {255,255,255,255}, endColour = {255,255,255,0};
+};
+
+/*
+ * Texture renderer that simulates and draws many small particles from the object's position.
+ * Particles are not game objects. They are stored in flat preallocated arrays,
+ * and all of them are drawn with a single geometry call. Emitters are simulated in parallel.
+ */
+class ParticleEmitter : public TextureRenderer
+{
+    public:
+
+        ParticleEmitter(ObjectHandle obj, std::shared_ptr<LTexture> texture, int capacity, ParticleSettings settings = ParticleSettings(), int z = 0, bool renderRelative = true, bool startEnabled = true);
+        ~ParticleEmitter();
+
+        virtual void Destroy();
+
+        virtual void ParallelUpdate();
+        virtual void Render(Camera *camera);
+
+        void Emit(int count);
+        void Clear();
+
+        bool Emitting() const;
+        void SetEmitting(bool emit);
+
+        ParticleSettings Settings() const;
+        void SetSettings(ParticleSettings newSettings);
+
+        int Count() const;
+        int Capacity() const;
+
+    private:
+
+        ParticleSettings settings;
+        /* Whether particles are emitted every frame at the settings' rate */
+        bool emitting = true;
+        /* Fractional particles carried over between frames */
+        float emit_accumulator = 0.0f;
+
+        /* The number of live particles. Live particles are always at the front of the arrays. */
+        int count = 0;
+        /* The maximum number of live particles */
+        int capacity;
+
+        /* ==========  PARTICLE ARRAYS  ========== */
+
+        std::vector<float> pos_x, pos_y;
+        std::vector<float> vel_x, vel_y;
+        /* Time each particle has been alive for, and the time it will die at */
+        std::vector<float> age, life;
+
+        /* ==========  VERTEX BUFFERS  ========== */
+
+        std::vector<float> vertex_xy;
+        std::vector<SDL_Color> vertex_colours;
+        /* Texture coordinates and indices are the same for every quad, so are only built once */
+        std::vector<float> vertex_uv;
+        std::vector<int> indices;
+
+        /* State of the emitter's random number generator */
+        Uint32 rng_state;
+
+        float random(float centre, float variance);
+        void kill(int i);
+};
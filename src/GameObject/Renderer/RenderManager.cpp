@@ -1,5 +1,8 @@
 #include "RenderManager.hpp"
 #include "TextureRenderer.hpp"
+#include "../Cameras/Camera.hpp"
+#include "../GameObject.hpp"
+#include "../../JobSystem.hpp"
 #include <algorithm>
 
 bool RendererComp::operator()(TextureRenderer* a, TextureRenderer* b) {
@@ -9,37 +12,396 @@ RendererComp comp;
 
 RenderManager::RenderManager()
 {
-
+    for (auto& version : layer_versions) version = 1;
 }
 
 RenderManager::~RenderManager()
 {
     renderers.clear();
+    disabled_renderers.clear();
+    for (auto& layer : layers) layer.clear();
+    for (auto& layer : sprite_layers) layer.clear();
+    sprites.clear();
+    free_sprites.clear();
+    cameras.clear();
 }
 
-/* Add a renderer object to the global vector. */
+/* Add a renderer object to the global vector, and to its render layer. */
 void RenderManager::AddRenderer(TextureRenderer *renderer)
 {
+    if (renderer->render_index != -1) return;
+    renderer->render_index = renderers.size();
     renderers.push_back(renderer);
-    std::sort(renderers.begin(), renderers.end(), comp);
+    // insert after all renderers with an equal z, to keep the layer sorted
+    auto& layer = layers[renderer->Layer()];
+    layer.insert(std::upper_bound(layer.begin(), layer.end(), renderer, comp), renderer);
+    DirtyLayer(renderer->Layer());
+    // so turning off the renderer's parents redraws the layer
+    renderer->add_render_layers(1u << renderer->Layer());
 }
 
 /* 
- * Removes the TextureRenderer from the vector. If the pointer is included multiple
- * times, only the first instance is removed. Does nothing if the TextureRenderer
- * is not in the vector.
+ * Removes the TextureRenderer from the vector and its render layer.
+ * Does nothing if the TextureRenderer is not in the vector.
  */
 void RenderManager::RemoveRenderer(TextureRenderer *renderer)
 {
-    // iterate through all pointers
-    for (auto it=renderers.begin(), e = renderers.end(); it!=e; it++) {
-        // when found, remove the matching element and end search
+    if (renderer->render_index == -1) return;
+    // fill the gap with the last renderer, since the order of the vector doesn't matter
+    auto& list = (renderer->render_parked)? disabled_renderers : renderers;
+    list[renderer->render_index] = list.back();
+    list[renderer->render_index]->render_index = renderer->render_index;
+    list.pop_back();
+    renderer->render_index = -1;
+    renderer->render_parked = false;
+
+    // remove from the render layer, only searching renderers with the same z
+    auto& layer = layers[renderer->Layer()];
+    auto range = std::equal_range(layer.begin(), layer.end(), renderer, comp);
+    for (auto it=range.first; it!=range.second; it++) {
         if (*it == renderer) {
-            renderers.erase(it);
+            layer.erase(it);
+            break;
+        }
+    }
+    DirtyLayer(renderer->Layer());
+}
+
+/*
+ * Removes every renderer belonging to an object waiting to be destroyed,
+ * with a single pass over the vector and each render layer.
+ */
+void RenderManager::RemovePending()
+{
+    auto pending = [](TextureRenderer *renderer) { return renderer->PendingDestroy(); };
+
+    bool removed = false;
+    for (auto list : {&renderers, &disabled_renderers}) {
+        auto end = std::remove_if(list->begin(), list->end(), [](TextureRenderer *renderer) {
+            if (!renderer->PendingDestroy()) return false;
+            renderer->render_index = -1;
+            renderer->render_parked = false;
+            return true;
+        });
+        if (end == list->end()) continue;
+        list->erase(end, list->end());
+        for (int i = 0; i < list->size(); i++) (*list)[i]->render_index = i;
+        removed = true;
+    }
+    if (!removed) return;
+
+    for (int i = 0; i < RENDER_LAYERS; i++) {
+        auto& layer = layers[i];
+        auto layer_end = std::remove_if(layer.begin(), layer.end(), pending);
+        if (layer_end == layer.end()) continue;
+        layer.erase(layer_end, layer.end());
+        DirtyLayer(i);
+    }
+}
+
+/* Adds a camera to be rendered at the end of the current frame. */
+void RenderManager::QueueCamera(Camera *camera)
+{
+    cameras.push_back(camera);
+}
+
+/* Removes a camera from the current frame's render queue. Does nothing if the camera is not queued. */
+void RenderManager::RemoveCamera(Camera *camera)
+{
+    for (auto it=cameras.begin(), e = cameras.end(); it!=e; it++) {
+        if (*it == camera) {
+            cameras.erase(it);
+            break;
+        }
+    }
+}
+
+/*
+ * Renders the current frame. All enabled renderers are prepared once, then
+ * every camera queued this frame culls and draws the renderers on its layers.
+ * Empties the camera queue when done.
+ *
+ * Renderers that can only be prepared on the main thread go first, since they may move or resize
+ * their objects. The rest are prepared, and sprites placed, in parallel on the job system's threads.
+ */
+void RenderManager::Render()
+{
+    GameObject::RefreshToggled();
+    prepare_main_thread();
+    jobSystem.RunPhase({
+        {"prepare renderers", RESOURCE_TRANSFORMS, RESOURCE_RENDERERS, [this]() { prepare_renderers(); }},
+        {"place sprites", RESOURCE_TRANSFORMS, RESOURCE_SPRITES, [this]() { place_sprites(); }},
+    });
+
+    // each camera only has to cull and submit
+    for (auto& camera : cameras) camera->Render();
+    cameras.clear();
+}
+
+/*
+ * Set whether a render layer is cached. Cameras draw a cached layer's renderers onto a 
+ * texture once, then draw that texture as a single quad every frame, until something
+ * on the layer changes or the camera's zoom changes.
+ * 
+ * Best suited to layers that rarely change, such as backgrounds.
+ */
+void RenderManager::SetLayerCached(int layer, bool cached)
+{
+    if (layer<0 || layer>=RENDER_LAYERS) return;
+    if (cached) cached_layers |= (1u<<layer);
+    else cached_layers &= ~(1u<<layer);
+    DirtyLayer(layer);
+}
+
+/* Whether a render layer is drawn from a cached texture. */
+bool RenderManager::LayerCached(int layer) const
+{
+    if (layer<0 || layer>=RENDER_LAYERS) return false;
+    return (cached_layers & (1u<<layer)) != 0;
+}
+
+/*
+ * Marks that something drawn on a render layer has changed, so any cached texture of the layer is redrawn.
+ * Safe to call from any thread.
+ */
+void RenderManager::DirtyLayer(int layer)
+{
+    if (layer>=0 && layer<RENDER_LAYERS) layer_versions[layer]++;
+}
+
+/* A counter incremented whenever anything drawn on a render layer changes. */
+unsigned int RenderManager::LayerVersion(int layer) const
+{
+    if (layer<0 || layer>=RENDER_LAYERS) return 0;
+    return layer_versions[layer];
+}
+
+/*
+ * Adds a sprite, drawn by cameras like a `TextureRenderer` but stored by value, 
+ * without a component object. 
+ * 
+ * \param texture The texture being rendered.
+ * \param owner The object the sprite is centred on and sized to. If `nullptr`, place the sprite with `SetSpriteRect`.
+ * \param z Value used to determine which order objects are rendered in.
+ * \param layer The render layer the sprite is drawn on.
+ * \param renderRelative Whether or not the sprite is rendered relative to cameras, or on the window directly.
+ * 
+ * \returns A handle used to change or remove the sprite.
+ */
+SpriteHandle RenderManager::AddSprite(std::shared_ptr<LTexture> texture, GameObject *owner, int z, int layer, bool renderRelative)
+{
+    // reuse a free slot, or add a new one
+    int index;
+    if (!free_sprites.empty()) {
+        index = free_sprites.back();
+        free_sprites.pop_back();
+    } else {
+        index = sprites.size();
+        sprites.emplace_back();
+    }
+
+    Sprite& sprite = sprites[index];
+    unsigned int generation = sprite.generation;
+    sprite = Sprite();
+    sprite.generation = generation;
+    sprite.alive = true;
+    sprite.texture = texture;
+    sprite.owner = owner;
+    sprite.z = z;
+    sprite.layer = clamp(0, RENDER_LAYERS-1, layer);
+    sprite.render_relative = renderRelative;
+
+    insert_sprite(index);
+    return {index, generation};
+}
+
+/* Removes a sprite, freeing its slot for reuse. Does nothing if the handle is stale. */
+void RenderManager::RemoveSprite(SpriteHandle handle)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+
+    erase_sprite(handle.index);
+    sprite->alive = false;
+    sprite->texture = nullptr;
+    sprite->owner = nullptr;
+    // invalidate every handle to this slot
+    sprite->generation++;
+    free_sprites.push_back(handle.index);
+}
+
+/* 
+ * The sprite a handle refers to. `nullptr` if the sprite has been removed.
+ * 
+ * \warning The pointer is invalidated when sprites are added. Use the `SetSprite` 
+ * functions to change the sprite, so cached layers are redrawn.
+ */
+const Sprite *RenderManager::GetSprite(SpriteHandle handle) const
+{
+    if (handle.index<0 || handle.index>=(int)sprites.size()) return nullptr;
+    const Sprite& sprite = sprites[handle.index];
+    return (sprite.alive && sprite.generation==handle.generation)? &sprite : nullptr;
+}
+
+/* Assign the texture a sprite renders. */
+void RenderManager::SetSpriteTexture(SpriteHandle handle, std::shared_ptr<LTexture> texture)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+    sprite->texture = texture;
+    DirtyLayer(sprite->layer);
+}
+
+/* Set the region of the texture a sprite draws. Width or height of 0 draws the whole texture. */
+void RenderManager::SetSpriteClip(SpriteHandle handle, SDL_Rect clip)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+    sprite->clip = clip;
+    DirtyLayer(sprite->layer);
+}
+
+/* Place a sprite in game space. Overwritten when a sprite's owner moves. */
+void RenderManager::SetSpriteRect(SpriteHandle handle, Math::RectF rect)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+    sprite->rect = rect;
+    DirtyLayer(sprite->layer);
+}
+
+/* Set the value used to determine which order a sprite is rendered in. */
+void RenderManager::SetSpriteZ(SpriteHandle handle, int z)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+    // reinsert to keep the layer sorted
+    erase_sprite(handle.index);
+    sprite->z = z;
+    insert_sprite(handle.index);
+}
+
+/* Set the render layer a sprite is drawn on. Clamped between `0` and `RENDER_LAYERS-1`. */
+void RenderManager::SetSpriteLayer(SpriteHandle handle, int layer)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+    erase_sprite(handle.index);
+    sprite->layer = clamp(0, RENDER_LAYERS-1, layer);
+    insert_sprite(handle.index);
+}
+
+/* Set whether a sprite is drawn flipped horizontally and/or vertically. */
+void RenderManager::SetSpriteFlip(SpriteHandle handle, SDL_RendererFlip flip)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+    sprite->flip = flip;
+    DirtyLayer(sprite->layer);
+}
+
+/* Set the colour and alpha a sprite's texture is modulated by. */
+void RenderManager::SetSpriteTint(SpriteHandle handle, SDL_Color tint)
+{
+    Sprite *sprite = get_sprite(handle);
+    if (sprite == nullptr) return;
+    sprite->tint = tint;
+    DirtyLayer(sprite->layer);
+}
+
+/* The sprite a handle refers to, or `nullptr` if it has been removed. */
+Sprite *RenderManager::get_sprite(SpriteHandle handle)
+{
+    return const_cast<Sprite*>(GetSprite(handle));
+}
+
+/* Adds a sprite slot to its render layer, after all sprites with an equal z. */
+void RenderManager::insert_sprite(int index)
+{
+    auto& layer = sprite_layers[sprites[index].layer];
+    int z = sprites[index].z;
+    auto it = std::upper_bound(layer.begin(), layer.end(), z, [this](int z, int i) { return z < sprites[i].z; });
+    layer.insert(it, index);
+    DirtyLayer(sprites[index].layer);
+    if (sprites[index].owner != nullptr) sprites[index].owner->add_render_layers(1u << sprites[index].layer);
+}
+
+/* Removes a sprite slot from its render layer, only searching sprites with the same z. */
+void RenderManager::erase_sprite(int index)
+{
+    auto& layer = sprite_layers[sprites[index].layer];
+    int z = sprites[index].z;
+    auto it = std::lower_bound(layer.begin(), layer.end(), z, [this](int i, int z) { return sprites[i].z < z; });
+    for (; it!=layer.end() && sprites[*it].z==z; it++) {
+        if (*it == index) {
+            layer.erase(it);
             break;
         }
     }
+    DirtyLayer(sprites[index].layer);
 }
 
 // create global manager object
-RenderManager renderManager = RenderManager();
\ No newline at end of file
+RenderManager renderManager = RenderManager();
+
+/*
+ * Moves a renderer that has been turned off out of the main vector, or a renderer that has been
+ * turned back on into it. Called for renderers under an object that was turned on or off, so
+ * disabled renderers aren't visited every frame.
+ */
+void RenderManager::RefreshRenderer(TextureRenderer *renderer)
+{
+    if (renderer->render_index == -1) return;
+    bool active = renderer->Enabled();
+    if (active == renderer->render_parked) move_renderer(renderer, !active);
+}
+
+/* Moves a renderer between the main and disabled vectors, leaving its render layer as it is */
+void RenderManager::move_renderer(TextureRenderer *renderer, bool parked)
+{
+    auto& from = (renderer->render_parked)? disabled_renderers : renderers;
+    from[renderer->render_index] = from.back();
+    from[renderer->render_index]->render_index = renderer->render_index;
+    from.pop_back();
+
+    auto& to = (parked)? disabled_renderers : renderers;
+    renderer->render_index = to.size();
+    renderer->render_parked = parked;
+    to.push_back(renderer);
+}
+
+/* Prepares each enabled renderer that can run on a worker thread, once, regardless of how many cameras see it */
+void RenderManager::prepare_renderers()
+{
+    jobSystem.ParallelFor(renderers.size(), 64, [this](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            TextureRenderer *renderer = renderers[i];
+            if (renderer->parallel_prepare && renderer->Enabled()) renderer->Prepare();
+        }
+    });
+}
+
+/* Prepares the enabled renderers that use SDL or change their object, before any job is started */
+void RenderManager::prepare_main_thread()
+{
+    for (auto& renderer : renderers) {
+        if (!renderer->parallel_prepare && renderer->Enabled()) renderer->Prepare();
+    }
+}
+
+/* Centres sprites on their owners, when the owner has moved or been resized */
+void RenderManager::place_sprites()
+{
+    jobSystem.ParallelFor(sprites.size(), 256, [this](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            Sprite& sprite = sprites[i];
+            if (!sprite.alive || sprite.owner == nullptr) continue;
+            if (sprite.owner->TransformVersion() == sprite.transform_version) continue;
+            sprite.transform_version = sprite.owner->TransformVersion();
+
+            Vector2 scale = sprite.owner->Scale(), origin = sprite.owner->Position() - (scale/2.0f);
+            sprite.rect = {origin.x, origin.y, scale.x, scale.y};
+            DirtyLayer(sprite.layer);
+        }
+    });
+}
@@ -1,10 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <memory>
 
+#include "Sprite.hpp"
+
+/* The number of render layers available to renderers and cameras. */
+#define RENDER_LAYERS 32
+/* Camera layer mask that includes every render layer. */
+#define ALL_RENDER_LAYERS 0xFFFFFFFFu
+
 // forwards declaration
 class TextureRenderer;
+class Camera;
 
 struct RendererComp {
     bool operator()(TextureRenderer* a, TextureRenderer* b);
@@ -20,10 +29,66 @@ class RenderManager
 
         void AddRenderer(TextureRenderer *renderer);
         void RemoveRenderer(TextureRenderer *renderer);
+        void RefreshRenderer(TextureRenderer *renderer);
+        void RemovePending();
+
+        void QueueCamera(Camera *camera);
+        void RemoveCamera(Camera *camera);
+
+        void Render();
+
+        void SetLayerCached(int layer, bool cached = true);
+        bool LayerCached(int layer) const;
+
+        void DirtyLayer(int layer);
+        unsigned int LayerVersion(int layer) const;
+
+        SpriteHandle AddSprite(std::shared_ptr<LTexture> texture, GameObject *owner = nullptr, int z = 0, int layer = 0, bool renderRelative = true);
+        void RemoveSprite(SpriteHandle handle);
+        const Sprite *GetSprite(SpriteHandle handle) const;
+
+        void SetSpriteTexture(SpriteHandle handle, std::shared_ptr<LTexture> texture);
+        void SetSpriteClip(SpriteHandle handle, SDL_Rect clip);
+        void SetSpriteRect(SpriteHandle handle, Math::RectF rect);
+        void SetSpriteZ(SpriteHandle handle, int z);
+        void SetSpriteLayer(SpriteHandle handle, int layer);
+        void SetSpriteFlip(SpriteHandle handle, SDL_RendererFlip flip);
+        void SetSpriteTint(SpriteHandle handle, SDL_Color tint);
 
-        /* Vector of pointers to all TextureRenderers. */
+        /* Vector of pointers to all TextureRenderers that were enabled when last checked. */
         std::vector<TextureRenderer*> renderers;
+        /* TextureRenderers that were disabled when last checked, which aren't prepared. */
+        std::vector<TextureRenderer*> disabled_renderers;
+
+        /* Pointers to all TextureRenderers on each render layer, sorted by z value. */
+        std::vector<TextureRenderer*> layers[RENDER_LAYERS];
+
+        /* Every sprite slot, stored by value. Slots that aren't `alive` are free. */
+        std::vector<Sprite> sprites;
+        /* Indices of the sprites on each render layer, sorted by z value. */
+        std::vector<int> sprite_layers[RENDER_LAYERS];
+
+    private:
+
+        /* Cameras that will render during the current frame. */
+        std::vector<Camera*> cameras;
+
+        /* Bitmask of the render layers drawn from a cached texture. Bit `n` represents layer `n`. */
+        unsigned int cached_layers = 0;
+        /* Counters incremented whenever anything drawn on each layer changes. Atomic, as renderers are prepared in parallel. */
+        std::atomic<unsigned int> layer_versions[RENDER_LAYERS];
+
+        /* Indices of sprite slots available for reuse */
+        std::vector<int> free_sprites;
+
+        Sprite *get_sprite(SpriteHandle handle);
+        void insert_sprite(int index);
+        void erase_sprite(int index);
+        void prepare_renderers();
+        void prepare_main_thread();
+        void move_renderer(TextureRenderer *renderer, bool parked);
+        void place_sprites();
 };
 
 // create global object
-extern RenderManager renderManager;
\ No newline at end of file
+extern RenderManager renderManager;
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <SDL.h>
+#include <memory>
+
+#include "../../Math/Math.hpp"
+
+// forwards declaration
+class LTexture;
+class GameObject;
+
+/* Identifies a sprite stored in the render manager */
+struct SpriteHandle {
+    /* The sprite's slot in the render manager's sprite array. `-1` for no sprite. */
+    int index = -1;
+    /* The generation of the slot when the sprite was created. Stale handles don't match. */
+    unsigned int generation = 0;
+
+    bool operator==(const SpriteHandle& other) const { return index==other.index && generation==other.generation; }
+    bool operator!=(const SpriteHandle& other) const { return !(*this==other); }
+};
+
+/* 
+ * A texture drawn by cameras without a component object. Stored by value in the render manager,
+ * and follows the position and scale of its owner object, if it has one.
+ */
+struct Sprite {
+    /* The texture being rendered */
+    std::shared_ptr<LTexture> texture = nullptr;
+    /* The region of the texture drawn. The whole texture if the width or height is 0. */
+    SDL_Rect clip = {0, 0, 0, 0};
+    /* The sprite's position and size in game space */
+    Math::RectF rect;
+    /* The object the sprite is centred on and sized to. `nullptr` to place the sprite manually. */
+    GameObject *owner = nullptr;
+
+    /* Value used to determine which order objects are rendered in */
+    int z = 0;
+    /* The render layer the sprite is drawn on */
+    int layer = 0;
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    /* Colour and alpha the texture is modulated by */
+    SDL_Color tint = {255, 255, 255, 255};
+    /* Whether or not the sprite is rendered relative to cameras, or on the window directly */
+    bool render_relative = true;
+
+    /* Whether the slot holds a sprite */
+    bool alive = false;
+    /* Incremented whenever the slot is freed, so old handles stop matching */
+    unsigned int generation = 0;
+    /* The owner's transform version when `rect` was last calculated */
+    unsigned int transform_version = 0;
+};
+
+/* A single textured rect to be drawn, collected by cameras so many can be transformed together */
+struct RenderQuad {
+    LTexture *texture = nullptr;
+    /* The region of the texture drawn. The whole texture if the width or height is 0. */
+    SDL_Rect clip = {0, 0, 0, 0};
+    SDL_RendererFlip flip = SDL_FLIP_NONE;
+    SDL_Color tint = {255, 255, 255, 255};
+};
@@ -1,6 +1,5 @@
 #include "TextRenderer.hpp"
 #include "../../GlobalWindow.hpp"
-#include <deque>
 
 /* 
  * Returns the original string as a vector of substrings seperated by 
@@ -35,6 +34,9 @@ std::vector<std::string> GetStrings(std::string original)
  * The string will be split into multiple different strings based on `newline` characters,
  * Where each newline will result in the text's strings being rendered on a different line.
  * 
+ * Text is drawn as quads from the font's glyph atlas, so changing the text
+ * does not rasterise anything or create any textures.
+ * 
  * \param object The game object the component is attached to.
  * \param text The text that will be rendered.
  * \param font The font that will be used for rendering. Leave as `nullptr` to use global font.
@@ -42,11 +44,13 @@ std::vector<std::string> GetStrings(std::string original)
  * \param useZoom Whether or not the texture is affected by camera zoom.
  * \param startEnabled Whether or not the component is active on creation. `true` by default.
  */
-TextRenderer::TextRenderer(std::shared_ptr<GameObject> object, std::string text, std::shared_ptr<LFont> font, int z, bool useZoom, bool startEnabled)
-: TextureRenderer(object, std::make_shared<LTexture>(gWindow), z, useZoom, startEnabled),
+TextRenderer::TextRenderer(ObjectHandle object, std::string text, std::shared_ptr<LFont> font, int z, bool useZoom, bool startEnabled)
+: TextureRenderer(object, nullptr, z, useZoom, startEnabled),
   text(text), fnt((font==nullptr)?gWindow->gFont:font), native_scale(object->Scale())
 {
-    create_texture();
+    // laying text out can create the font's atlas and resizes the object, so only on the main thread
+    parallel_prepare = false;
+    layout_text();
 }
 
 TextRenderer::~TextRenderer()
@@ -58,6 +62,8 @@ void TextRenderer::Destroy()
 {
     TextureRenderer::Destroy();
     fnt = nullptr;
+    glyphs.clear();
+    vertices.clear();
 }
 
 /* The string that gets rendered. */
@@ -65,67 +71,132 @@ std::string TextRenderer::Text() const { return text; }
 /* The font used for text rendering. */
 std::shared_ptr<LFont> TextRenderer::Font() const { return fnt; }
 
-/* Change what string is rendered. Recreates the texture using the same font, but new string. */
+/* Change what string is rendered. Lays the text out again using the same font, but new string. */
 void TextRenderer::SetText(std::string newText)
 {
+    // nothing to lay out if the text is the same
+    if (newText == text) return;
     text = newText;
-    create_texture();
+    layout_text();
 }
 
 /* 
  * Change what font is used for rendering. 
- * Recreates the texture using the same text, but new font. 
+ * Lays the text out again using the same text, but new font. 
  * If a `nullptr` is provided, the default global font will be used.
  */
 void TextRenderer::SetFont(std::shared_ptr<LFont> newFont)
 {
     fnt = (newFont==nullptr)? gWindow->gFont : newFont;
-    create_texture();
+    layout_text();
 }
 
 /* 
- * Creates the object's texture using the stored font and string text. 
- * Resizes the parent object to match the dimensions of the new texture.
+ * Positions every glyph of the text using the stored font, with each line centred.
+ * Glyphs not yet in the font's atlas are added to it.
+ * Resizes the parent object to match the dimensions of the laid out text.
  */
-void TextRenderer::create_texture()
+void TextRenderer::layout_text()
 {
-    auto strings = GetStrings(text);
+    glyphs.clear();
+    text_w = text_h = 0;
+
+    auto atlas = fnt->getAtlas(gWindow->gRenderer);
+    if (atlas == nullptr) {
+        atlas_id = 0;
+        return;
+    }
+    atlas_id = atlas->getId();
 
-    // turn all strings into textures, and store in deque
-    std::deque<std::shared_ptr<LTexture>> textures;
-    // track the width and height required to store all the textures
-    int w = 0, h = 0;
+    // lay out each line from the left, tracking where each line starts and how wide it is
+    auto strings = GetStrings(text);
+    std::vector<size_t> line_start;
+    std::vector<int> line_w;
     for (auto& str : strings)
     {
-        // create texture
-        auto tex = std::make_shared<LTexture>(gWindow);
-        tex->loadFromRenderedText(str, fnt->getColour(), fnt->get());
-        // add texture to deque
-        textures.push_front(tex);
-        // readjust width and height
-        h += tex->getHeight();
-        w = max(w, tex->getWidth());
+        line_start.push_back(glyphs.size());
+        int pen = 0, w = 0;
+        Uint16 prev = 0;
+        for (unsigned char ch : str)
+        {
+            auto glyph = atlas->getGlyph(ch);
+            if (glyph == nullptr) continue;
+            if (prev != 0) pen += atlas->getKerning(prev, ch);
+            // place the glyph at the pen position, on the current line
+            SDL_Rect dst = {pen+glyph->offset, text_h, glyph->src.w, glyph->src.h};
+            glyphs.push_back({glyph->src, dst});
+            // advance the pen, and track the line's width
+            pen += glyph->advance;
+            w = max(w, max(pen, dst.x+dst.w));
+            prev = ch;
+        }
+        line_w.push_back(w);
+        text_w = max(text_w, w);
+        text_h += atlas->getLineHeight();
     }
 
-    // create a blank texture with the dimensions calculated
-    texture->solidColour({0,0,0,0}, w, h);
+    // centre each line
+    line_start.push_back(glyphs.size());
+    for (size_t i=0; i<line_w.size(); i++) {
+        int x = (text_w-line_w[i])/2;
+        for (size_t j=line_start[i]; j<line_start[i+1]; j++) glyphs[j].dst.x += x;
+    }
 
-    // render each string texture onto the base, centred
-    int y = 0;
-    while (!textures.empty())
+    Vector2 scale(text_w, text_h);
+    // resize object based on new text dimensions
+    obj->SetScale(scale & native_scale);
+    MarkDirty();
+}
+
+/*
+ * Lays the text out again if the font has been reloaded since it was last laid out, then
+ * updates the renderer's rect. Called once per frame by the render manager, before any
+ * camera renders, so the object is never resized while cameras are drawing.
+ */
+void TextRenderer::Prepare()
+{
+    if (fnt != nullptr) {
+        auto atlas = fnt->getAtlas(gWindow->gRenderer);
+        if (atlas != nullptr && atlas->getId() != atlas_id) layout_text();
+    }
+    TextureRenderer::Prepare();
+}
+
+/* Draws the text's glyphs from the font's atlas, relative to a camera, in a single draw call. */
+void TextRenderer::Render(Camera *camera)
+{
+    if (fnt == nullptr) return;
+    auto atlas = fnt->getAtlas(gWindow->gRenderer);
+    // not laid out with this atlas yet, so the glyphs' regions would be wrong
+    if (atlas == nullptr || atlas->getId() != atlas_id) return;
+    if (glyphs.empty() || text_w <= 0 || text_h <= 0) return;
+
+    SDL_Rect rend_rect;
+    // outside of camera view, don't render
+    if (!get_render_rect(camera, &rend_rect)) return;
+
+    // scale from laid out text to screen, and from atlas pixels to texture coordinates
+    float sx = rend_rect.w / (float)text_w, sy = rend_rect.h / (float)text_h;
+    float u = 1.0f / atlas->getWidth(), v = 1.0f / atlas->getHeight();
+    SDL_Color colour = fnt->getColour();
+
+    // four vertices per glyph
+    vertices.resize(glyphs.size()*4);
+    for (size_t i=0; i<glyphs.size(); i++)
     {
-        // get texture from back
-        auto tex = textures.back();
-        textures.pop_back();
-        // find the centre point
-        int x = (w-tex->getWidth())/2;
-        // render string in place
-        tex->render_toTexture(texture.get(), x, y);
-        // increment y coordinate
-        y += tex->getHeight();
+        const SDL_Rect &src = glyphs[i].src, &dst = glyphs[i].dst;
+        float x0 = rend_rect.x + (dst.x*sx), y0 = rend_rect.y + (dst.y*sy),
+              x1 = x0 + (dst.w*sx), y1 = y0 + (dst.h*sy);
+        float u0 = src.x*u, v0 = src.y*v,
+              u1 = (src.x+src.w)*u, v1 = (src.y+src.h)*v;
+
+        SDL_Vertex *vert = &vertices[i*4];
+        vert[0] = {{x0,y0}, colour, {u0,v0}};
+        vert[1] = {{x1,y0}, colour, {u1,v0}};
+        vert[2] = {{x0,y1}, colour, {u0,v1}};
+        vert[3] = {{x1,y1}, colour, {u1,v1}};
     }
 
-    Vector2 scale(texture->getWidth(), texture->getHeight());
-    // resize object based on new texture dimensions
-    obj->SetScale(scale & native_scale);
+    atlas->renderQuads(vertices.data(), glyphs.size());
+    gWindow->countDraw(atlas->getTexture(), glyphs.size()*4);
 }
\ No newline at end of file
@@ -4,12 +4,20 @@
 
 std::vector<std::string> GetStrings(std::string original);
 
+/* A glyph in laid out text */
+struct TextGlyph {
+    /* The region of the font's atlas holding the glyph */
+    SDL_Rect src;
+    /* Where the glyph is placed, relative to the top left of the text */
+    SDL_Rect dst;
+};
+
 /* A Texture renderer whose texture is a rendered string. */
 class TextRenderer : public TextureRenderer
 {
     public:
 
-        TextRenderer(std::shared_ptr<GameObject> object, std::string text, std::shared_ptr<LFont> font = nullptr, int z = 0, bool use_zoom = true, bool startEnabled = true);
+        TextRenderer(ObjectHandle object, std::string text, std::shared_ptr<LFont> font = nullptr, int z = 0, bool use_zoom = true, bool startEnabled = true);
         ~TextRenderer();
 
         virtual void Destroy();
@@ -20,7 +28,10 @@ class TextRenderer : public TextureRenderer
         virtual void SetText(std::string newText);
         virtual void SetFont(std::shared_ptr<LFont> newFont);
 
-        virtual void create_texture();
+        virtual void Prepare();
+        virtual void Render(Camera *camera);
+
+        virtual void layout_text();
 
     private:
 
@@ -34,4 +45,14 @@ class TextRenderer : public TextureRenderer
          * the product of this and the texture dimensions. 
          */
         Vector2 native_scale;
+
+        /* Every glyph of the text, positioned relative to the top left of the text */
+        std::vector<TextGlyph> glyphs;
+        /* Dimensions of the laid out text, in pixels */
+        int text_w = 0, text_h = 0;
+        /* Id of the glyph atlas the text was laid out with */
+        unsigned int atlas_id = 0;
+
+        /* Vertex buffer reused between draws */
+        std::vector<SDL_Vertex> vertices;
 };
\ No newline at end of file
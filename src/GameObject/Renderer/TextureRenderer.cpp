@@ -15,7 +15,7 @@
  * \param renderRelative Whether or not the object is rendered relative to cameras, or on the window directly.
  * \param startEnabled Whether or not the component is active on creation. `true` by default.
  */
-TextureRenderer::TextureRenderer(std::shared_ptr<GameObject> object, std::shared_ptr<LTexture> texture, int z, bool renderRelative, bool startEnabled)
+TextureRenderer::TextureRenderer(ObjectHandle object, std::shared_ptr<LTexture> texture, int z, bool renderRelative, bool startEnabled)
 : ObjectComponent(object, startEnabled), texture(texture), z(z), render_relative(renderRelative)
 {
     renderManager.AddRenderer(this);
@@ -38,12 +38,41 @@ void TextureRenderer::Destroy()
 /* 
  * Sets the dimensions of renderer's rect to the object's scale.
  * Centre's the rect on the object's position.
+ * 
+ * Called once per frame by the render manager, before any camera renders.
+ * The rect is only recalculated when the object has moved or been resized
+ * since the last call.
  */
-void TextureRenderer::Update()
+void TextureRenderer::Prepare()
 {
+    // the texture's pixels, colour or alpha have changed, so cached layers must be redrawn
+    if (texture != nullptr && texture->getVersion() != texture_version) {
+        texture_version = texture->getVersion();
+        MarkDirty();
+    }
+
+    // object's transform is unchanged, rect is still valid
+    if (obj->TransformVersion() == transform_version) return;
+    transform_version = obj->TransformVersion();
+
     Vector2 scale = obj->Scale();
     Vector2 origin = obj->Position() - (scale/2.0f);
     rect = {origin.x,origin.y,scale.x,scale.y};
+    MarkDirty();
+}
+
+/* Enables or disables the renderer, and marks its render layer as changed. */
+void TextureRenderer::SetEnabled(bool enable)
+{
+    ObjectComponent::SetEnabled(enable);
+    MarkDirty();
+}
+
+/* Moves the renderer in or out of the render manager's main vector when turned on or off */
+void TextureRenderer::refresh_active()
+{
+    ObjectComponent::refresh_active();
+    renderManager.RefreshRenderer(this);
 }
 
 /* Render the stored texture relative to a camera. Doesn't render is outside the camera's view. */
@@ -51,45 +80,97 @@ void TextureRenderer::Render(Camera *camera)
 {
     if (texture != nullptr) 
     {
-        // camera region
-        RectF cam = camera->camera();
-
-        // set up rect for rendering based on the camera's position
-        Vector2 origin(rect.x, rect.y), dim(rect.w, rect.h);
-        // adjust for zoom
-        if (render_relative) 
-        {
-            float zoom = camera->Zoom();
-
-            Vector2 cp = camera->Position(), d = origin - cp;
-            origin = cp + (d * zoom);
-            dim *= zoom;
-            origin.x -= cam.x;
-            origin.y -= cam.y;
-        }
-
-        // create the rect
-        SDL_Rect rend_rect = {
-            int(origin.x), int(origin.y),
-            int(dim.x), int(dim.y)
-        };
-
+        SDL_Rect rend_rect;
         // outside of camera view, don't render
-        if (rend_rect.x<-rend_rect.w || rend_rect.x>cam.w ||
-            rend_rect.y<-rend_rect.h || rend_rect.y>cam.h) return;
+        if (!get_render_rect(camera, &rend_rect)) return;
 
         // render the texture with respect to the rect
         texture->render(&rend_rect);
     }
 }
 
+/*
+ * Describes the renderer as a single textured quad over its rect, so cameras can transform 
+ * and draw it in a batch instead of calling `Render`.
+ * 
+ * Subclasses that redefine `Render` without redefining `GetQuad` are always drawn
+ * through `Render`.
+ * 
+ * \returns `true` if the quad was filled in. `false` to be drawn with `Render`.
+ */
+bool TextureRenderer::GetQuad(RenderQuad *quad)
+{
+    quad->texture = texture.get();
+    return true;
+}
+
+/*
+ * Finds where the renderer's rect appears on screen when viewed by a camera.
+ * 
+ * \param camera The camera being rendered to.
+ * \param rend_rect Pointer to store the on screen rect in.
+ * 
+ * \returns `true` if the rect is within the camera's view. `false` if it is outside, and shouldn't be rendered.
+ */
+bool TextureRenderer::get_render_rect(Camera *camera, SDL_Rect *rend_rect)
+{
+    return get_render_rect(camera, rect, rend_rect);
+}
+
+/*
+ * Finds where a rect in the game appears on screen when viewed by a camera.
+ * 
+ * \param camera The camera being rendered to.
+ * \param area The rect in game space.
+ * \param rend_rect Pointer to store the on screen rect in.
+ * 
+ * \returns `true` if the rect is within the camera's view. `false` if it is outside, and shouldn't be rendered.
+ */
+bool TextureRenderer::get_render_rect(Camera *camera, RectF area, SDL_Rect *rend_rect)
+{
+    return camera->ScreenRect(area, render_relative, rend_rect);
+}
+
 /* Value used to determine which order objects are rendered in. */
 int TextureRenderer::Z() const { return z; }
 /* Set the value used to determine which order objects are rendered in. */
 void TextureRenderer::SetZ(int newZ) 
 { 
-    z = newZ; 
     // remove and reinsert self to global map, to update the sorted order
     renderManager.RemoveRenderer(this);
+    z = newZ; 
     renderManager.AddRenderer(this);
-}
\ No newline at end of file
+}
+
+/* The render layer the renderer is drawn on. Cameras only render layers included in their layer mask. */
+int TextureRenderer::Layer() const { return layer; }
+/* 
+ * Set the render layer the renderer is drawn on. Cameras only render layers 
+ * included in their layer mask. Clamped between `0` and `RENDER_LAYERS-1`.
+ */
+void TextureRenderer::SetLayer(int newLayer)
+{
+    // remove and reinsert self to the global manager, to move between layer lists
+    renderManager.RemoveRenderer(this);
+    layer = clamp(0, RENDER_LAYERS-1, newLayer);
+    renderManager.AddRenderer(this);
+}
+/* Whether or not the object is rendered relative to cameras, or on the window directly. */
+bool TextureRenderer::RenderRelative() const { return render_relative; }
+
+/* Whether cameras draw the renderer in batches, rather than calling `Render`. */
+bool TextureRenderer::Batched() const { return batched; }
+
+/* Assign the texture being rendered. */
+void TextureRenderer::SetTexture(std::shared_ptr<LTexture> newTexture)
+{
+    texture = newTexture;
+    MarkDirty();
+}
+
+/* 
+ * Marks that what the renderer draws has changed, so cameras redraw any cached texture 
+ * of its render layer. Should be called by subclasses whenever their appearance changes
+ * without their object moving.
+ */
+void TextureRenderer::MarkDirty() { renderManager.DirtyLayer(layer); }
@@ -12,14 +12,17 @@ class TextureRenderer : public ObjectComponent
 {
     public:
 
-        TextureRenderer(std::shared_ptr<GameObject> obj, std::shared_ptr<LTexture> texture, int z = 0, bool renderRelative = true, bool startEnabled = true);
+        TextureRenderer(ObjectHandle obj, std::shared_ptr<LTexture> texture, int z = 0, bool renderRelative = true, bool startEnabled = true);
         ~TextureRenderer();
 
         virtual void Destroy();
 
-        virtual void Update();
+        virtual void SetEnabled(bool enable);
+
+        virtual void Prepare();
 
         virtual void Render(Camera *camera);
+        virtual bool GetQuad(RenderQuad *quad);
 
         /* The texture being rendered */
         std::shared_ptr<LTexture> texture = nullptr;
@@ -30,10 +33,53 @@ class TextureRenderer : public ObjectComponent
         int Z() const;
         void SetZ(int newZ);
 
+        int Layer() const;
+        void SetLayer(int newLayer);
+
+        bool RenderRelative() const;
+        bool Batched() const;
+
+        void SetTexture(std::shared_ptr<LTexture> newTexture);
+        void MarkDirty();
+
+    protected:
+
+        virtual void refresh_active();
+
+        bool get_render_rect(Camera *camera, SDL_Rect *rend_rect);
+        bool get_render_rect(Camera *camera, RectF area, SDL_Rect *rend_rect);
+
+        /* Whether or not the object is rendered relative to cameras, or on the window directly. */
+        bool render_relative;
+
+        /*
+         * Whether `Prepare` can run on a worker thread, alongside other renderers. Set to `false`
+         * in subclasses whose `Prepare` uses SDL or changes anything besides the renderer itself,
+         * to have it called on the main thread before any renderer is prepared in parallel.
+         */
+        bool parallel_prepare = true;
+
     private:
 
         /* Value used to determine which order objects are rendered in. */
         int z;
-        /* Whether or not the object is rendered relative to cameras, or on the window directly. */
-        bool render_relative;
+        /* The render layer the renderer is drawn on. */
+        int layer = 0;
+
+        /* The object's transform version when `rect` was last calculated. */
+        unsigned int transform_version = 0;
+        /* The texture's version when the renderer was last prepared */
+        unsigned int texture_version = 0;
+
+        /* The renderer's position in the render manager's vector. `-1` when not in it. */
+        int render_index = -1;
+        /* Whether the renderer is in the render manager's disabled vector, rather than the main one */
+        bool render_parked = false;
+        /*
+         * Whether cameras draw the renderer in batches, using `GetQuad`. Set when added to an object,
+         * to `false` if its type redefines `Render` but not `GetQuad`.
+         */
+        bool batched = false;
+        friend class RenderManager;
+        friend class GameObject;
 };
\ No newline at end of file
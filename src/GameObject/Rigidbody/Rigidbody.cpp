@@ -1,6 +1,9 @@
 #include "Rigidbody.hpp"
 #include "PhysicsConstants.hpp"
+#include "../Colliders/ColliderManager.hpp"
 #include "../../TimeTracker.hpp"
+#include <algorithm>
+#include <cmath>
 
 /*
  * Component for moving colliding objects apart using elastic collision.
@@ -16,7 +19,7 @@
  * \param hasGravity Whether or not the object is affected by gravity. `true` by default.
  * \param startEnabled Whether or not the component is active on creation. `true` by default.
  */
-Rigidbody::Rigidbody(std::shared_ptr<GameObject> object, float mass, float frictionCoefficient, Vector2 velocity, bool isMoveable, bool hasGravity, bool startEnabled)
+Rigidbody::Rigidbody(ObjectHandle object, float mass, float frictionCoefficient, Vector2 velocity, bool isMoveable, bool hasGravity, bool startEnabled)
 : ObjectComponent(object, startEnabled), 
   mass(mass), velocity(velocity), is_moveable(isMoveable), has_gravity(hasGravity), friction_coeff(frictionCoefficient)
 {
@@ -40,12 +43,13 @@ void Rigidbody::Destroy()
 }
 
 /*  
- * Performs collision behaviour with all other rigidbodies.
+ * Performs collision behaviour with all other rigidbodies, using the collisions found this frame.
  * Updates velocity based on acceleration, and position based on velocity.
  * 
- * Sets the position of parent object after all checks.
+ * Sets the position of parent object after all checks. Runs in the physics phase, right after
+ * every collider has looked for collisions, so collisions and positions are from the same moment.
  */
-void Rigidbody::Update()
+void Rigidbody::PhysicsUpdate()
 {
     // collide with every object in collision with the box collider
     // perform collision behaviour with all objects the collider is in contact with 
@@ -55,13 +59,17 @@ void Rigidbody::Update()
     // update based on velocity and acceleration
     Vector2 pos = obj->Position() + (velocity * gTime.deltaTime());
     obj->SetPosition(pos);
+    // keep out of static geometry, such as tilemaps
+    resolve_static_collisions();
     Vector2 accel = (has_gravity)? acceleration+physicsConstants.gravity : acceleration;
     velocity += accel * gTime.deltaTime();
 }
 
-/* If the collision is with another enabled rigidbody, perform elastic collision with respect to the other object. */
+/* If the collision is with another existing, enabled rigidbody, perform elastic collision with respect to the other object. */
 void Rigidbody::OnCollision(Collision collision)
 {
+    // the other object may have been destroyed since the collision was found
+    if (collision.other == nullptr) return;
     // get the rigidbody component from the other object 
     auto other = collision.other->GetComponent<Rigidbody>();
 
@@ -191,8 +199,65 @@ void Rigidbody::push_objects_apart(std::shared_ptr<Rigidbody> other, Vector2 dis
 
     // remove collisions, to avoid repeat rigidbody behaviour
     auto col = other->GetCollider();
-    collider->remove_collision(other->obj, col);
-    col->remove_collision(obj, collider);
+    collider->remove_collision(other->obj, col.get());
+    col->remove_collision(obj, collider.get());
+}
+
+/*
+ * Pushes the object out of any static geometry it overlaps, and cancels its velocity into it.
+ * Overlaps are resolved largest first, so a body sliding across the edge between two rects 
+ * is pushed out by the one it is sunk into the most, and no longer overlaps the other.
+ */
+void Rigidbody::resolve_static_collisions()
+{
+    if (!is_moveable || colliderManager.static_colliders.empty()) return;
+
+    Vector2 s = obj->Scale(), pos = obj->Position();
+    RectF box = {pos.x-(s.x/2.0f), pos.y-(s.y/2.0f), s.x, s.y};
+
+    // find all static rects the object is inside
+    std::vector<RectF> rects;
+    float friction = 0.0f;
+    colliderManager.QueryStatic(box, &rects, &friction);
+    if (rects.empty()) return;
+
+    // the depth of the overlap between the object and a rect along each axis
+    auto overlap = [&box](const RectF& r) {
+        return Vector2(
+            min(box.x+box.w, r.x+r.w) - max(box.x, r.x),
+            min(box.y+box.h, r.y+r.h) - max(box.y, r.y)
+        );
+    };
+    std::sort(rects.begin(), rects.end(), [&overlap](const RectF& a, const RectF& b) {
+        Vector2 oa = overlap(a), ob = overlap(b);
+        return oa.x*oa.y > ob.x*ob.y;
+    });
+
+    bool touched = false;
+    for (auto& r : rects)
+    {
+        // earlier pushes may have already moved the object out of this rect
+        Vector2 vec = overlap(r);
+        if (vec.x<=0.0f || vec.y<=0.0f) continue;
+        touched = true;
+
+        // push out along the shallowest axis, away from the rect's centre
+        if (vec.x<vec.y) {
+            float dir = (box.x+(box.w/2.0f) < r.x+(r.w/2.0f))? -1.0f : 1.0f;
+            box.x += (vec.x+physicsConstants.rigidbodySeperation)*dir;
+            if (velocity.x*dir < 0.0f) velocity.x = 0.0f;
+        } else {
+            float dir = (box.y+(box.h/2.0f) < r.y+(r.h/2.0f))? -1.0f : 1.0f;
+            box.y += (vec.y+physicsConstants.rigidbodySeperation)*dir;
+            if (velocity.y*dir < 0.0f) velocity.y = 0.0f;
+        }
+    }
+
+    if (!touched) return;
+    obj->SetPosition(Vector2(box.x+(box.w/2.0f), box.y+(box.h/2.0f)));
+    // static geometry never moves, so friction slows the object towards rest.
+    // the coefficient is the fraction of velocity lost every 60th of a second, so the slowdown doesn't depend on frame rate
+    velocity = velocity * powf(max(0.0f, 1.0f-friction), gTime.deltaTime()*60.0f);
 }
 
 /* The collider object that the rigidbody's parent uses for collision detection. */
@@ -8,12 +8,12 @@ class Rigidbody : public ObjectComponent
 {
     public:
 
-        Rigidbody(std::shared_ptr<GameObject> object, float mass, float frictionCoefficient, Vector2 velocity = Vector2_Zero, bool isMoveable = true, bool hasGravity = true, bool startEnabled = true);
+        Rigidbody(ObjectHandle object, float mass, float frictionCoefficient, Vector2 velocity = Vector2_Zero, bool isMoveable = true, bool hasGravity = true, bool startEnabled = true);
         ~Rigidbody();
 
         virtual void Destroy();
 
-        virtual void Update();
+        virtual void PhysicsUpdate();
 
         virtual void OnCollision(Collision collision);
 
@@ -61,4 +61,5 @@ class Rigidbody : public ObjectComponent
         void elastic_collision(Vector2& other_vel, float other_mass);
         void apply_friction(Vector2& other_vel, float other_friction, bool other_moveable);
         void push_objects_apart(std::shared_ptr<Rigidbody> other, Vector2 disp);
+        void resolve_static_collisions();
 };
\ No newline at end of file
@@ -1,5 +1,9 @@
 #include "Game.hpp"
 #include "../../InputHandler.hpp"
+#include "../../AsyncLoader.hpp"
+#include "../Renderer/RenderManager.hpp"
+#include "../../TimeTracker.hpp"
+#include "../../ECS/Systems.hpp"
 
 /* The game that holds all scenes. Creates a single `Default Scene` on creation */
 Game::Game()
@@ -14,13 +18,22 @@ Game::~Game()
     current_scene = nullptr;
 }
 
-/* Update the scenes and all its component objects. */
+/* Update the scenes and all its component objects, then render the frame. */
 void Game::Update()
 {
+    // apply assets that finished loading in the background
+    asyncLoader.Update();
+
     if (current_scene != nullptr) {
         current_scene->Update();
         current_scene->UpdateComponents();
     }
+    // update entities stored outside the object tree
+    RunSystems(ecsWorld, gTime.deltaTime());
+    // destroy everything removed during the update, before it can be drawn
+    GameObject::FlushDestroyed();
+    // draw with every camera that updated this frame
+    renderManager.Render();
     inputHandler.Update();
 }
 
@@ -82,7 +95,7 @@ std::vector<std::shared_ptr<Scene>> Game::GetScenes() const
 }
 
 /* Removes the object pointer from the current scene. */
-void Game::RemoveFromScene(std::shared_ptr<GameObject> obj) {
+void Game::RemoveFromScene(ObjectHandle obj) {
     if (current_scene != nullptr) current_scene->RemoveComponent(obj);
 }
 
@@ -90,8 +103,8 @@ void Game::RemoveFromScene(std::shared_ptr<GameObject> obj) {
 Game game = Game();
 
 
-/* Removes the object pointer from the current scene. */
-void DestroyObject(std::shared_ptr<GameObject> obj) {
+/* Removes the object from the current scene. It is destroyed at the end of the frame. */
+void DestroyObject(ObjectHandle obj) {
     game.RemoveFromScene(obj);
 }
 
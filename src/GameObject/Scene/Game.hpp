@@ -117,7 +117,7 @@ class Game
             return current_scene->GetComponents<T>();
         }
 
-        void RemoveFromScene(std::shared_ptr<GameObject> obj);
+        void RemoveFromScene(ObjectHandle obj);
 
     private:
 
@@ -148,7 +148,7 @@ std::shared_ptr<T> Instantiate(Args&&... args) {
     return game.AddToScene<T>(std::forward<Args>(args)...);
 }
 
-void DestroyObject(std::shared_ptr<GameObject> obj);
+void DestroyObject(ObjectHandle obj);
 
 /* 
  * Creates a new scene with the given name and adds it to the game. 
@@ -1,5 +1,7 @@
 #include "Scene.hpp"
 #include "../Cameras/Camera.hpp"
+#include "../Colliders/ColliderManager.hpp"
+#include "../../TimeTracker.hpp"
 
 /*
  * Game object with a name. Intended to serve as a root container for other game objects.
@@ -9,6 +11,8 @@
 Scene::Scene(std::string name)
 : GameObject(), name(name)
 {
+    SetArena(std::make_shared<PoolArena>());
+    SetUpdateList(&updates);
     // add a camera to the scene by default
     AddComponent<Camera>(Vector2_Zero);
 }
@@ -18,9 +22,33 @@ Scene::~Scene()
     Destroy();
 }
 
+/*
+ * Destroys every object in the scene, each running its destructor, then gives the arena's slabs
+ * back to the heap together rather than freeing each object's block.
+ */
 void Scene::Destroy()
 {
     GameObject::Destroy();
+    updates.Clear();
+    SetUpdateList(&updates);
+    if (Arena() != nullptr) Arena()->Release();
+}
+
+/*
+ * Updates every enabled object in the scene, one phase at a time. Rather than walking the object tree,
+ * the scene keeps a flat list for each phase of the objects whose type redefines that phase's function.
+ */
+void Scene::UpdateComponents()
+{
+    for (int i = 0; i < gTime.FixedSteps(); i++) updates.Run(PHASE_FIXED_UPDATE);
+    // collisions are found and responded to in the same frame, from the same positions
+    colliderManager.UpdateBoundingBoxes();
+    updates.Run(PHASE_COLLISION);
+    updates.Run(PHASE_PHYSICS);
+    updates.Run(PHASE_UPDATE);
+    updates.Run(PHASE_PARALLEL_UPDATE);
+    updates.Run(PHASE_LATE_UPDATE);
+    updates.Run(PHASE_PRE_RENDER);
 }
 
 /* What happens when the scene is entered. Redefine in subclass definitions. */
@@ -33,4 +61,11 @@ void Scene::OnSceneEnter()
 void Scene::OnSceneExit()
 {
     
+}
+
+/* Occupancy of the arena the scene's objects are allocated from */
+PoolStats Scene::MemoryStats() const
+{
+    if (Arena() == nullptr) return PoolStats();
+    return Arena()->Stats();
 }
\ No newline at end of file
@@ -4,7 +4,10 @@
 
 #include <string>
 
-/* Game object with a name. Intended to serve as a root container for other game objects. */
+/*
+ * Game object with a name. Intended to serve as a root container for other game objects.
+ * Every object in the scene is allocated from the scene's own pool arena.
+ */
 class Scene : public GameObject
 {
     public:
@@ -14,8 +17,17 @@ class Scene : public GameObject
 
         virtual void Destroy();
 
+        virtual void UpdateComponents();
+
         virtual void OnSceneEnter();
         virtual void OnSceneExit();
 
+        PoolStats MemoryStats() const;
+
         std::string name;
+
+    private:
+
+        /* Every object in the scene that needs updating, in order */
+        UpdateList updates;
 };
\ No newline at end of file
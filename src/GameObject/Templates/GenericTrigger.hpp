@@ -3,6 +3,8 @@
 #include "../GameObject.hpp"
 #include "../Colliders/BoxCollider.hpp"
 
+#include <unordered_set>
+
 /*
  * Region that will activeate or deactivate upon the prescence (or lack thereof) 
  * of a gameobject of a specific type. 
@@ -79,20 +81,24 @@ class GenericTrigger : public GameObject
         virtual void OnCollisionEnter(Collision collision)
         {
             // desired object type enters
-            if (typeid(*collision.other) == typeid(T)) {
+            if (collision.other != nullptr && typeid(*collision.other) == typeid(T)) {
                 // make active and call enter function
+                occupants.insert(collision.other);
                 active = true;
                 EnterFunc();
             }
         }
 
-        /* Check if the exiting object is of the correct type, and update accordingly. */
-        virtual void OnCollisionExit(std::shared_ptr<GameObject> other)
+        /*
+         * Check if the exiting object is of the correct type, and update accordingly.
+         * A destroyed object's handle no longer resolves, so it is recognised by the handle it entered with.
+         */
+        virtual void OnCollisionExit(ObjectHandle other)
         {
             // object type is leaving
-            if (typeid(*other) == typeid(T)) {
-                // make inactive and call exit function
-                active = false;
+            if (occupants.erase(other) != 0) {
+                // make inactive once no T objects remain, and call exit function
+                active = !occupants.empty();
                 ExitFunc();
             }
         }
@@ -104,4 +110,6 @@ class GenericTrigger : public GameObject
 
         /* Whether or not a T object is present in the trigger. */
         bool active = true;
+        /* Handles of the T objects in the trigger */
+        std::unordered_set<ObjectHandle> occupants;
 };
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "Tilemap.hpp"
+#include "../Cameras/Camera.hpp"
+#include "../../GlobalWindow.hpp"
+
+/*
+ * Renders a grid of tiles from a tileset texture. The top left of the map is placed
+ * at the object's position. All tiles start empty.
+ *
+ * \param object The game object the component is attached to.
+ * \param tileset The texture tiles are taken from. Tile ids count left to right, top to bottom.
+ * \param tilePixels The width and height of each tile in the tileset, in pixels.
+ * \param width, height The dimensions of the map, in tiles.
+ * \param tileSize The dimensions of each tile in game space.
+ * \param z Value used to determine which order objects are rendered in.
+ * \param startEnabled Whether or not the component is active on creation. `true` by default.
+ */
+Tilemap::Tilemap(ObjectHandle object, std::shared_ptr<LTexture> tileset, int tilePixels, int width, int height, Vector2 tileSize, int z, bool startEnabled)
+: TextureRenderer(object, nullptr, z, true, startEnabled),
+  tileset(tileset), tile_px(max(tilePixels, 1)), map_w(max(width, 0)), map_h(max(height, 0)), tile_size(tileSize)
+{
+    tileset_columns = (tileset==nullptr)? 1 : max(tileset->getWidth()/tile_px, 1);
+    tiles.assign(map_w*map_h, EMPTY_TILE);
+
+    // round up, so partial chunks cover the edges of the map
+    chunks_w = (map_w+TILEMAP_CHUNK_SIZE-1)/TILEMAP_CHUNK_SIZE;
+    chunks_h = (map_h+TILEMAP_CHUNK_SIZE-1)/TILEMAP_CHUNK_SIZE;
+    chunks.resize(chunks_w*chunks_h);
+}
+
+Tilemap::~Tilemap()
+{
+    Destroy();
+}
+
+void Tilemap::Destroy()
+{
+    TextureRenderer::Destroy();
+    chunks.clear();
+    tileset = nullptr;
+}
+
+/* Sets the renderer's rect to cover the whole map, with its top left at the object's position. */
+void Tilemap::Prepare()
+{
+    Vector2 origin = obj->Position();
+    if (origin.x == rect.x && origin.y == rect.y) return;
+    rect = {origin.x, origin.y, map_w*tile_size.x, map_h*tile_size.y};
+    MarkDirty();
+}
+
+/* 
+ * Renders each chunk in the camera's view as a single quad. 
+ * Chunks with changed tiles are redrawn first. 
+ */
+void Tilemap::Render(Camera *camera)
+{
+    if (tileset == nullptr || chunks.empty()) return;
+
+    // find the region of the game visible to the camera
+    ViewTransform view = camera->View();
+    Vector2 view_min = view.Inverse(Vector2_Zero),
+            view_max = view.Inverse(Vector2(view.width, view.height));
+
+    // only visit the chunks overlapping the visible region
+    Vector2 chunk_size = tile_size * (float)TILEMAP_CHUNK_SIZE;
+    int x0 = max(0, (int)std::floor((view_min.x-rect.x)/chunk_size.x)),
+        y0 = max(0, (int)std::floor((view_min.y-rect.y)/chunk_size.y)),
+        x1 = min(chunks_w-1, (int)std::floor((view_max.x-rect.x)/chunk_size.x)),
+        y1 = min(chunks_h-1, (int)std::floor((view_max.y-rect.y)/chunk_size.y));
+
+    for (int cy=y0; cy<=y1; cy++) {
+        for (int cx=x0; cx<=x1; cx++)
+        {
+            TilemapChunk& chunk = chunks[cy*chunks_w + cx];
+            if (chunk.dirty) bake_chunk(cx, cy);
+            if (chunk.texture == nullptr) continue;
+
+            RectF area = {rect.x + cx*chunk_size.x, rect.y + cy*chunk_size.y, chunk_size.x, chunk_size.y};
+            SDL_Rect rend_rect;
+            if (get_render_rect(camera, area, &rend_rect)) chunk.texture->render(&rend_rect);
+        }
+    }
+}
+
+/* Redraws all of a chunk's tiles onto its texture, with a single render target switch. */
+void Tilemap::bake_chunk(int cx, int cy)
+{
+    TilemapChunk& chunk = chunks[cy*chunks_w + cx];
+    chunk.dirty = false;
+
+    // find the tiles in the chunk, clipped to the map
+    int tx0 = cx*TILEMAP_CHUNK_SIZE, ty0 = cy*TILEMAP_CHUNK_SIZE,
+        tx1 = min(tx0+TILEMAP_CHUNK_SIZE, map_w), ty1 = min(ty0+TILEMAP_CHUNK_SIZE, map_h);
+
+    // don't keep a texture for empty chunks
+    bool empty = true;
+    for (int y=ty0; y<ty1 && empty; y++) {
+        for (int x=tx0; x<tx1 && empty; x++) empty = tiles[y*map_w + x] == EMPTY_TILE;
+    }
+    if (empty) {
+        chunk.texture = nullptr;
+        return;
+    }
+
+    // create the chunk's texture the first time it has tiles, and reuse it for every later bake
+    int size = TILEMAP_CHUNK_SIZE*tile_px;
+    if (chunk.texture == nullptr || chunk.texture->getWidth() != size) {
+        chunk.texture = std::make_shared<LTexture>(gWindow);
+        if (!chunk.texture->solidColour({0,0,0,0}, size, size)) {
+            chunk.texture = nullptr;
+            return;
+        }
+    }
+
+    // clear the old tiles, then draw each tile from the tileset
+    if (!chunk.texture->setAsRenderTarget()) return;
+    SDL_SetRenderDrawColor(gWindow->gRenderer, 0, 0, 0, 0);
+    SDL_RenderClear(gWindow->gRenderer);
+    for (int y=ty0; y<ty1; y++) {
+        for (int x=tx0; x<tx1; x++)
+        {
+            int id = tiles[y*map_w + x];
+            if (id == EMPTY_TILE) continue;
+            SDL_Rect src = {(id%tileset_columns)*tile_px, (id/tileset_columns)*tile_px, tile_px, tile_px},
+                     dst = {(x-tx0)*tile_px, (y-ty0)*tile_px, tile_px, tile_px};
+            tileset->render(&dst, &src);
+        }
+    }
+    chunk.texture->resetRenderTarget();
+}
+
+/* The id of the tile at the given position in the map. `EMPTY_TILE` if the position is outside the map. */
+int Tilemap::GetTile(int x, int y) const
+{
+    if (x<0 || y<0 || x>=map_w || y>=map_h) return EMPTY_TILE;
+    return tiles[y*map_w + x];
+}
+
+/* 
+ * Sets the tile at the given position in the map. Only the chunk containing the tile is redrawn.
+ * Does nothing if the position is outside the map. 
+ */
+void Tilemap::SetTile(int x, int y, int id)
+{
+    if (x<0 || y<0 || x>=map_w || y>=map_h) return;
+    int& tile = tiles[y*map_w + x];
+    if (tile == id) return;
+    tile = id;
+    TilemapChunk& chunk = chunks[(y/TILEMAP_CHUNK_SIZE)*chunks_w + (x/TILEMAP_CHUNK_SIZE)];
+    chunk.dirty = true;
+    chunk.version++;
+    MarkDirty();
+}
+
+/* Sets every tile in the map to the same id. */
+void Tilemap::Fill(int id)
+{
+    tiles.assign(tiles.size(), id);
+    for (auto& chunk : chunks) {
+        chunk.dirty = true;
+        chunk.version++;
+    }
+    MarkDirty();
+}
+
+/* The position in the map of the tile containing a point in game space. May be outside the map. */
+Vector2Int Tilemap::WorldToTile(Vector2 point) const
+{
+    Vector2 origin = obj->Position();
+    return Vector2Int((int)std::floor((point.x-origin.x)/tile_size.x), (int)std::floor((point.y-origin.y)/tile_size.y));
+}
+
+/* The region of game space covered by the tile at the given position in the map. */
+RectF Tilemap::TileRect(int x, int y) const
+{
+    Vector2 origin = obj->Position();
+    return {origin.x + x*tile_size.x, origin.y + y*tile_size.y, tile_size.x, tile_size.y};
+}
+
+/* The width of the map, in tiles. */
+int Tilemap::Width() const { return map_w; }
+/* The height of the map, in tiles. */
+int Tilemap::Height() const { return map_h; }
+/* The dimensions of each tile in game space. */
+Vector2 Tilemap::TileSize() const { return tile_size; }
+/* The width and height of each tile in the tileset, in pixels. */
+int Tilemap::TilePixels() const { return tile_px; }
+
+/* The number of chunks across the map. */
+int Tilemap::ChunksWidth() const { return chunks_w; }
+/* The number of chunks down the map. */
+int Tilemap::ChunksHeight() const { return chunks_h; }
+/* 
+ * A counter incremented whenever one of a chunk's tiles changes.
+ * Used to tell when anything derived from the chunk's tiles is out of date.
+ * `0` if the chunk is outside the map.
+ */
+unsigned int Tilemap::ChunkVersion(int cx, int cy) const
+{
+    if (cx<0 || cy<0 || cx>=chunks_w || cy>=chunks_h) return 0;
+    return chunks[cy*chunks_w + cx].version;
+}
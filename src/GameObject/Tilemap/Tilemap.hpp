@@ -0,0 +1,75 @@
+#pragma once
+
+#include "../Renderer/TextureRenderer.hpp"
+
+/* The width and height of tilemap chunks, in tiles */
+#define TILEMAP_CHUNK_SIZE 16
+/* Tile id representing no tile */
+#define EMPTY_TILE -1
+
+/* A square region of a tilemap, rendered to a single texture */
+struct TilemapChunk {
+    /* All the chunk's tiles, drawn onto one texture. `nullptr` if the chunk has no tiles. */
+    std::shared_ptr<LTexture> texture = nullptr;
+    /* Whether the chunk's tiles have changed since its texture was drawn */
+    bool dirty = true;
+    /* Incremented whenever one of the chunk's tiles changes */
+    unsigned int version = 1;
+};
+
+/*
+ * Renders a grid of tiles from a tileset texture. Tiles are stored as ids in a dense grid,
+ * and drawn in chunks, each baked to its own texture. Cameras only draw the chunk textures
+ * in view, and chunks are only redrawn when one of their tiles changes.
+ */
+class Tilemap : public TextureRenderer
+{
+    public:
+
+        Tilemap(ObjectHandle object, std::shared_ptr<LTexture> tileset, int tilePixels, int width, int height, Vector2 tileSize, int z = 0, bool startEnabled = true);
+        ~Tilemap();
+
+        virtual void Destroy();
+
+        virtual void Prepare();
+        virtual void Render(Camera *camera);
+
+        int GetTile(int x, int y) const;
+        void SetTile(int x, int y, int id);
+        void Fill(int id);
+
+        Vector2Int WorldToTile(Vector2 point) const;
+        RectF TileRect(int x, int y) const;
+
+        int Width() const;
+        int Height() const;
+        Vector2 TileSize() const;
+        int TilePixels() const;
+
+        int ChunksWidth() const;
+        int ChunksHeight() const;
+        unsigned int ChunkVersion(int cx, int cy) const;
+
+    private:
+
+        /* The texture tiles are taken from. Tile ids count left to right, top to bottom. */
+        std::shared_ptr<LTexture> tileset;
+        /* The width and height of each tile in the tileset, in pixels */
+        int tile_px;
+        /* The number of tiles across each row of the tileset */
+        int tileset_columns;
+
+        /* The id of every tile, row by row */
+        std::vector<int> tiles;
+        /* The dimensions of the map, in tiles */
+        int map_w, map_h;
+        /* The dimensions of each tile in game space */
+        Vector2 tile_size;
+
+        /* Every chunk, row by row */
+        std::vector<TilemapChunk> chunks;
+        /* The number of chunks across and down the map */
+        int chunks_w, chunks_h;
+
+        void bake_chunk(int cx, int cy);
+};
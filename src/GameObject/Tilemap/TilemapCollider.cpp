@@ -0,0 +1,147 @@
+#include "TilemapCollider.hpp"
+#include "../Colliders/ColliderManager.hpp"
+
+/*
+ * Component that builds static collision geometry from the object's `Tilemap`.
+ * The `Tilemap` component must be added to `object` before the collider.
+ * 
+ * Adds this object to the global static colliders vector.
+ * 
+ * \param object The object that the component is attached to.
+ * \param frictionCoefficient Coefficient of friction applied to rigidbodies touching the tiles. `0` by default.
+ * \param startEnabled Whether or not the component is active on creation. `true` by default.
+ */
+TilemapCollider::TilemapCollider(ObjectHandle object, float frictionCoefficient, bool startEnabled)
+: ObjectComponent(object, startEnabled), friction_coeff(frictionCoefficient)
+{
+    tilemap = obj->GetComponent<Tilemap>();
+    if (tilemap != nullptr) chunks.resize(tilemap->ChunksWidth()*tilemap->ChunksHeight());
+    // add self to global static colliders vector
+    colliderManager.AddStaticCollider(this);
+}
+
+TilemapCollider::~TilemapCollider()
+{
+    Destroy();
+}
+
+/* Remove self from global static colliders vector */
+void TilemapCollider::Destroy()
+{
+    ObjectComponent::Destroy();
+    colliderManager.RemoveStaticCollider(this);
+    chunks.clear();
+    tilemap = nullptr;
+}
+
+/* 
+ * Whether tiles with the given id are collided with. By default, every tile except `EMPTY_TILE` is solid.
+ * Override to make some tiles passable.
+ */
+bool TilemapCollider::IsSolid(int id) const { return id != EMPTY_TILE; }
+
+/*
+ * Finds the merged rects overlapping an area. Chunks in the area are re-merged first
+ * if their tiles have changed.
+ * 
+ * \param area The rect in game space to search.
+ * \param out Pointer to the vector to append overlapping rects to, in game space.
+ */
+void TilemapCollider::Query(RectF area, std::vector<RectF> *out)
+{
+    if (tilemap == nullptr || chunks.empty()) return;
+
+    // convert the area into chunk coordinates
+    Vector2 origin = obj->Position(), tile_size = tilemap->TileSize(),
+            chunk_size = tile_size * (float)TILEMAP_CHUNK_SIZE;
+    int cw = tilemap->ChunksWidth(), ch = tilemap->ChunksHeight();
+    int x0 = max(0, (int)std::floor((area.x-origin.x)/chunk_size.x)),
+        y0 = max(0, (int)std::floor((area.y-origin.y)/chunk_size.y)),
+        x1 = min(cw-1, (int)std::floor((area.x+area.w-origin.x)/chunk_size.x)),
+        y1 = min(ch-1, (int)std::floor((area.y+area.h-origin.y)/chunk_size.y));
+
+    for (int cy=y0; cy<=y1; cy++) {
+        for (int cx=x0; cx<=x1; cx++)
+        {
+            TilemapColliderChunk& chunk = chunks[cy*cw + cx];
+            if (chunk.version != tilemap->ChunkVersion(cx, cy)) merge_chunk(cx, cy);
+
+            for (auto& r : chunk.rects)
+            {
+                RectF rect = {origin.x + r.x*tile_size.x, origin.y + r.y*tile_size.y, r.w*tile_size.x, r.h*tile_size.y};
+                // only keep rects that overlap the area
+                if (rect.x < area.x+area.w && area.x < rect.x+rect.w &&
+                    rect.y < area.y+area.h && area.y < rect.y+rect.h) out->push_back(rect);
+            }
+        }
+    }
+}
+
+/* Re-merges every chunk. Needed if the result of `IsSolid` changes without the tiles changing. */
+void TilemapCollider::Rebuild()
+{
+    if (tilemap == nullptr) return;
+    for (int cy=0; cy<tilemap->ChunksHeight(); cy++) {
+        for (int cx=0; cx<tilemap->ChunksWidth(); cx++) merge_chunk(cx, cy);
+    }
+}
+
+/*
+ * Covers a chunk's solid tiles with as few rects as possible, using greedy meshing.
+ * Each rect is grown as far right as it can go, then as far down as the whole row allows.
+ */
+void TilemapCollider::merge_chunk(int cx, int cy)
+{
+    TilemapColliderChunk& chunk = chunks[cy*tilemap->ChunksWidth() + cx];
+    chunk.version = tilemap->ChunkVersion(cx, cy);
+    chunk.rects.clear();
+
+    // find the tiles in the chunk, clipped to the map
+    int tx0 = cx*TILEMAP_CHUNK_SIZE, ty0 = cy*TILEMAP_CHUNK_SIZE,
+        w = min(TILEMAP_CHUNK_SIZE, tilemap->Width()-tx0), h = min(TILEMAP_CHUNK_SIZE, tilemap->Height()-ty0);
+
+    // mark the solid tiles that haven't been covered yet
+    bool open[TILEMAP_CHUNK_SIZE][TILEMAP_CHUNK_SIZE];
+    for (int y=0; y<h; y++) {
+        for (int x=0; x<w; x++) open[y][x] = IsSolid(tilemap->GetTile(tx0+x, ty0+y));
+    }
+
+    for (int y=0; y<h; y++) {
+        for (int x=0; x<w; x++)
+        {
+            if (!open[y][x]) continue;
+
+            // grow right
+            int rw = 1;
+            while (x+rw<w && open[y][x+rw]) rw++;
+
+            // grow down, while the whole row below is open
+            int rh = 1;
+            for (bool full=true; y+rh<h; rh++) {
+                for (int i=0; i<rw && full; i++) full = open[y+rh][x+i];
+                if (!full) break;
+            }
+
+            // cover the rect's tiles
+            for (int j=0; j<rh; j++) {
+                for (int i=0; i<rw; i++) open[y+j][x+i] = false;
+            }
+            chunk.rects.push_back({tx0+x, ty0+y, rw, rh});
+        }
+    }
+}
+
+/* The tilemap that collision geometry is built from. */
+std::shared_ptr<Tilemap> TilemapCollider::GetTilemap() const { return tilemap; }
+/* Coefficient of friction applied to rigidbodies touching the tiles. */
+float TilemapCollider::FrictionCoefficient() const { return friction_coeff; }
+/* Assign the coefficient of friction applied to rigidbodies touching the tiles. */
+void TilemapCollider::SetFrictionCoefficient(float frictionCoefficient) { friction_coeff = frictionCoefficient; }
+
+/* The number of merged rects in chunks that have been built so far. */
+int TilemapCollider::RectCount() const
+{
+    int count = 0;
+    for (auto& chunk : chunks) count += chunk.rects.size();
+    return count;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../ObjectComponent.hpp"
+#include "Tilemap.hpp"
+#include <vector>
+
+/* The merged collision geometry of a single tilemap chunk */
+struct TilemapColliderChunk {
+    /* Rects covering every solid tile in the chunk, in tile coordinates */
+    std::vector<SDL_Rect> rects;
+    /* The version of the tilemap chunk that the rects were built from */
+    unsigned int version = 0;
+};
+
+/*
+ * Component that builds static collision geometry from the object's `Tilemap`.
+ * Adjacent solid tiles are merged into as few rects as possible, one chunk at a time,
+ * and a chunk is only re-merged after its tiles change. Rigidbodies are pushed out
+ * of the merged rects, but the tiles never move.
+ */
+class TilemapCollider : public ObjectComponent
+{
+    public:
+
+        TilemapCollider(ObjectHandle object, float frictionCoefficient = 0.0f, bool startEnabled = true);
+        ~TilemapCollider();
+
+        virtual void Destroy();
+
+        virtual bool IsSolid(int id) const;
+
+        void Query(RectF area, std::vector<RectF> *out);
+        void Rebuild();
+
+        std::shared_ptr<Tilemap> GetTilemap() const;
+        float FrictionCoefficient() const;
+        void SetFrictionCoefficient(float frictionCoefficient);
+        int RectCount() const;
+
+    private:
+
+        /* The tilemap that collision geometry is built from */
+        std::shared_ptr<Tilemap> tilemap;
+        /* Coefficient of friction applied to rigidbodies touching the tiles */
+        float friction_coeff;
+
+        /* The merged rects of every chunk, row by row */
+        std::vector<TilemapColliderChunk> chunks;
+
+        void merge_chunk(int cx, int cy);
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+/* Number identifying a type at runtime, without RTTI */
+typedef unsigned int TypeIdValue;
+
+/* Hands out type ids in order of first use */
+inline TypeIdValue NextTypeId()
+{
+    static TypeIdValue next = 0;
+    return next++;
+}
+
+/*
+ * A number unique to type `T`. Ids are small and dense, assigned the first time each type
+ * is asked for, so they can be used as keys or indices.
+ * 
+ * \note ids are only consistent within a single run of the program.
+ */
+template <typename T>
+TypeIdValue TypeId()
+{
+    static const TypeIdValue id = NextTypeId();
+    return id;
+}
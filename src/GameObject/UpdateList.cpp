@@ -0,0 +1,197 @@
+#include "UpdateList.hpp"
+#include "GameObject.hpp"
+#include "../JobSystem.hpp"
+
+#include <algorithm>
+
+/*
+ * Adds an object to the end of the list. Does nothing if the object is already in a list.
+ * Disabled objects are set aside until they are enabled.
+ */
+void UpdateList::Add(GameObject *object)
+{
+    if (object->listed || object->parked_index != -1 || object->restore_queued) return;
+    object->update_order = next_order++;
+    if (!object->Enabled()) {
+        park(object);
+        return;
+    }
+    insert(object);
+}
+
+/* Removes an object from the list. Gaps in the phases are filled in before their next update. */
+void UpdateList::Remove(GameObject *object)
+{
+    if (object->parked_index != -1) unpark(object);
+    if (object->restore_queued) {
+        restoring.erase(std::find(restoring.begin(), restoring.end(), object));
+        object->restore_queued = false;
+    }
+    unlink(object);
+}
+
+/* Removes every object from the list */
+void UpdateList::Clear()
+{
+    for (auto& list : phases) {
+        for (auto object : list) {
+            if (object == nullptr) continue;
+            object->listed = false;
+            for (auto& index : object->phase_index) index = -1;
+        }
+        list.clear();
+    }
+    for (auto object : parked) object->parked_index = -1;
+    parked.clear();
+    for (auto object : restoring) object->restore_queued = false;
+    restoring.clear();
+    for (auto& count : holes) count = 0;
+}
+
+/*
+ * Runs one update phase for every object in it whose object and parents are all enabled.
+ * Objects added during the phase are updated too. The parallel update phase runs in batches
+ * across the job system's threads.
+ *
+ * Objects turned off since the last phase are set aside, and set aside objects that are
+ * enabled again are put back in their original place. Only objects under the ones turned
+ * on or off are visited to do so, so disabled objects aren't visited every frame.
+ */
+void UpdateList::Run(UpdatePhase phase)
+{
+    GameObject::RefreshToggled();
+    if (!restoring.empty()) restore_enabled();
+    if (holes[phase] > 0) compact(phase);
+    auto& list = phases[phase];
+
+    if (phase == PHASE_PARALLEL_UPDATE) {
+        jobSystem.ParallelFor(list.size(), 16, [&list](int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                GameObject *object = list[i];
+                if (object != nullptr && object->Enabled()) object->ParallelUpdate();
+            }
+        });
+        return;
+    }
+
+    for (int i = 0; i < list.size(); i++) {
+        GameObject *object = list[i];
+        // objects turned off during this frame haven't been set aside yet
+        if (object == nullptr || !object->Enabled()) continue;
+        switch (phase) {
+            case PHASE_FIXED_UPDATE: object->FixedUpdate(); break;
+            case PHASE_PHYSICS: object->PhysicsUpdate(); break;
+            case PHASE_COLLISION: object->CollisionUpdate(); break;
+            case PHASE_LATE_UPDATE: object->LateUpdate(); break;
+            case PHASE_PRE_RENDER: object->PreRender(); break;
+            case PHASE_UPDATE:
+                if (object->phases & PHASE_BIT(PHASE_UPDATE)) object->Update();
+                // objects that redefine `UpdateComponents` update their own components
+                if (list[i] == object && object->custom_traversal && object->Enabled()) object->UpdateComponents();
+                break;
+            default: break;
+        }
+    }
+}
+
+/* Number of enabled objects in the list for a phase */
+int UpdateList::Size(UpdatePhase phase) const { return phases[phase].size() - holes[phase]; }
+
+
+/* ==========  HELPER FUNCTIONS  ========== */
+
+/* Puts an object in the array of each phase it takes part in */
+void UpdateList::insert(GameObject *object)
+{
+    unsigned int mask = object->listed_phases();
+    for (int phase = 0; phase < UPDATE_PHASES; phase++) {
+        if (!(mask & PHASE_BIT(phase)) || object->phase_index[phase] != -1) continue;
+        object->phase_index[phase] = phases[phase].size();
+        phases[phase].push_back(object);
+    }
+    object->listed = true;
+}
+
+/* Takes an object out of every phase array, leaving gaps */
+void UpdateList::unlink(GameObject *object)
+{
+    for (int phase = 0; phase < UPDATE_PHASES; phase++) {
+        int& index = object->phase_index[phase];
+        if (index == -1) continue;
+        phases[phase][index] = nullptr;
+        index = -1;
+        holes[phase]++;
+    }
+    object->listed = false;
+}
+
+/* Sets a disabled object aside */
+void UpdateList::park(GameObject *object)
+{
+    unlink(object);
+    object->parked_index = parked.size();
+    parked.push_back(object);
+}
+
+/*
+ * Sets an object in the list aside if it is inactive, or queues it to be put back if it is
+ * active again. Called for objects under one that was turned on or off.
+ */
+void UpdateList::Refresh(GameObject *object)
+{
+    bool active = object->Enabled();
+    if (!active && object->listed) park(object);
+    else if (active && object->parked_index != -1) {
+        unpark(object);
+        object->restore_queued = true;
+        restoring.push_back(object);
+    }
+}
+
+/* Takes an object out of the set aside objects, by moving the last one into its place */
+void UpdateList::unpark(GameObject *object)
+{
+    parked[object->parked_index] = parked.back();
+    parked[object->parked_index]->parked_index = object->parked_index;
+    parked.pop_back();
+    object->parked_index = -1;
+}
+
+/* Puts every object queued to be restored back where it was in the update order */
+void UpdateList::restore_enabled()
+{
+    std::vector<GameObject*> enabled;
+    for (auto object : restoring) {
+        object->restore_queued = false;
+        // turned off again since being queued
+        if (!object->Enabled()) park(object);
+        else enabled.push_back(object);
+    }
+    restoring.clear();
+    if (enabled.empty()) return;
+
+    // each phase array is always in the order objects were added, so merge the restored objects into them
+    auto by_order = [](GameObject *a, GameObject *b) { return a->update_order < b->update_order; };
+    std::sort(enabled.begin(), enabled.end(), by_order);
+    int ends[UPDATE_PHASES];
+    for (int phase = 0; phase < UPDATE_PHASES; phase++) {
+        compact(phase);
+        ends[phase] = phases[phase].size();
+    }
+    for (auto object : enabled) insert(object);
+    for (int phase = 0; phase < UPDATE_PHASES; phase++) {
+        auto& list = phases[phase];
+        if (ends[phase] == list.size()) continue;
+        std::inplace_merge(list.begin(), list.begin()+ends[phase], list.end(), by_order);
+        for (int i = 0; i < list.size(); i++) list[i]->phase_index[phase] = i;
+    }
+}
+
+/* Closes the gaps left by removed objects in a phase, keeping the rest in order */
+void UpdateList::compact(int phase)
+{
+    auto& list = phases[phase];
+    list.erase(std::remove(list.begin(), list.end(), nullptr), list.end());
+    for (int i = 0; i < list.size(); i++) list[i]->phase_index[phase] = i;
+    holes[phase] = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <vector>
+
+// forwards declaration
+class GameObject;
+
+/* The passes objects are updated in every frame, in the order they run */
+enum UpdatePhase
+{
+    /* `FixedUpdate`, run zero or more times a frame at a fixed rate */
+    PHASE_FIXED_UPDATE,
+    /* `CollisionUpdate`, used by colliders to find collisions, once every bounding box has been placed */
+    PHASE_COLLISION,
+    /* `PhysicsUpdate`, used by rigidbodies to respond to the collisions just found and move */
+    PHASE_PHYSICS,
+    /* `Update`, and `UpdateComponents` for objects that redefine it */
+    PHASE_UPDATE,
+    /* `ParallelUpdate`, spread across the job system's threads */
+    PHASE_PARALLEL_UPDATE,
+    /* `LateUpdate`, for things that follow other objects, such as cameras */
+    PHASE_LATE_UPDATE,
+    /* `PreRender`, used by cameras to queue themselves once everything has moved */
+    PHASE_PRE_RENDER,
+    UPDATE_PHASES
+};
+
+/* Bit representing an update phase in a bitmask of phases */
+#define PHASE_BIT(phase) (1u << (phase))
+
+/*
+ * Flat arrays, one per update phase, of the objects in a tree that need updating every frame.
+ * Objects are only in the arrays of the phases their type redefines the function of, and are stored
+ * in the order they were added, so parents always come before their components.
+ * Disabled objects are set aside, rather than skipped every frame.
+ */
+class UpdateList
+{
+    public:
+
+        void Add(GameObject *object);
+        void Remove(GameObject *object);
+        void Clear();
+
+        void Run(UpdatePhase phase);
+        void Refresh(GameObject *object);
+
+        int Size(UpdatePhase phase = PHASE_UPDATE) const;
+
+    private:
+
+        /* Objects in update order for each phase. Removed objects leave a `nullptr` until the next compaction. */
+        std::vector<GameObject*> phases[UPDATE_PHASES];
+        /* Number of `nullptr` entries in each phase */
+        int holes[UPDATE_PHASES] = {};
+
+        /* Disabled objects, left out of the arrays above until enabled. In no particular order. */
+        std::vector<GameObject*> parked;
+        /* Objects enabled again, put back in the arrays together before the next phase runs */
+        std::vector<GameObject*> restoring;
+        /* Given to each object added, so restored objects go back in the right place */
+        unsigned int next_order = 1;
+
+        void insert(GameObject *object);
+        void unlink(GameObject *object);
+        void park(GameObject *object);
+        void unpark(GameObject *object);
+        void restore_enabled();
+        void compact(int phase);
+};
@@ -32,4 +32,19 @@ Math::Vector2Int GetWindowResolution() {
 
 void SetWindowPosition(int x, int y) {
     gWindow->setPosition(x, y);
+}
+
+/* Whether the game is running without a display. Set by the `BUNGUS_HEADLESS` environment variable. */
+bool IsHeadless() {
+    return gWindow->isHeadless();
+}
+
+/* Saves the current frame as a PNG once it has finished rendering. */
+void SaveFrame(std::string path) {
+    gWindow->captureFrame(path);
+}
+
+/* Draw calls, culled renderers, texture switches and render target switches of the last finished frame. */
+LRenderStats GetRenderStats() {
+    return gWindow->getRenderStats();
 }
\ No newline at end of file
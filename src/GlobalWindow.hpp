@@ -25,4 +25,8 @@ void SetWindowSize(int width, int height, bool changeResolution = true, int x =
 Math::Vector2Int GetWindowDimensions();
 Math::Vector2Int GetWindowResolution();
 
-void SetWindowPosition(int x = SDL_WINDOWPOS_CENTERED, int y = SDL_WINDOWPOS_CENTERED);
\ No newline at end of file
+void SetWindowPosition(int x = SDL_WINDOWPOS_CENTERED, int y = SDL_WINDOWPOS_CENTERED);
+
+bool IsHeadless();
+void SaveFrame(std::string path);
+LRenderStats GetRenderStats();
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "JobSystem.hpp"
+
+#include <cstdlib>
+
+JobSystem jobSystem;
+
+/* The index of the current thread's queue. `0` on the main thread, and any thread that isn't a worker. */
+static thread_local int current_thread = 0;
+/* Whether the current thread is running a job, or a batch of a parallel for */
+static thread_local bool in_job = false;
+
+/*
+ * Starts the worker threads.
+ *
+ * \param threadCount The number of threads jobs run on, including the main thread. If `0`,
+ * uses `BUNGUS_THREADS` if it is set, otherwise one thread per hardware thread.
+ */
+JobSystem::JobSystem(int threadCount)
+{
+    if (threadCount <= 0) {
+        const char *env = std::getenv(JOBS_ENV_VAR);
+        if (env != nullptr) threadCount = std::atoi(env);
+    }
+    if (threadCount <= 0) threadCount = std::thread::hardware_concurrency();
+    if (threadCount <= 0) threadCount = 1;
+
+    for (int i = 0; i < threadCount; i++) queues.push_back(std::make_unique<JobQueue>());
+    for (int i = 1; i < threadCount; i++) workers.emplace_back(&JobSystem::worker_loop, this, i);
+}
+
+/* Stops the worker threads, once they finish their current jobs */
+JobSystem::~JobSystem()
+{
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+/*
+ * Queues a job to run on any thread.
+ *
+ * \param job The function to run.
+ * \param group Group to wait on for the job to finish. `nullptr` if it won't be waited for.
+ */
+void JobSystem::Submit(std::function<void()> job, JobGroup *group)
+{
+    if (group != nullptr) group->remaining++;
+    {
+        JobQueue& queue = *queues[current_thread];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back({std::move(job), group});
+    }
+    queued++;
+    {
+        // taking the lock means a worker can't miss the job between checking for work and sleeping
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+    }
+    wake.notify_one();
+}
+
+/* Runs queued jobs on the calling thread until every job in the group has finished */
+void JobSystem::Wait(JobGroup& group)
+{
+    while (group.remaining.load() > 0) {
+        if (!run_one(current_thread)) std::this_thread::yield();
+    }
+}
+
+/*
+ * Runs a list of jobs, in parallel where possible. A job runs after every earlier job in the
+ * list that writes something it reads or writes, or reads something it writes. Jobs without
+ * such conflicts run at the same time. Returns once every job is done.
+ */
+void JobSystem::RunPhase(const std::vector<PhaseJob>& jobs)
+{
+    // put each job in the wave after the last earlier job it conflicts with
+    std::vector<int> wave(jobs.size(), 0);
+    int waves = 0;
+    for (int i = 0; i < jobs.size(); i++) {
+        for (int j = 0; j < i; j++) {
+            bool conflict = (jobs[i].writes & (jobs[j].reads|jobs[j].writes)) || (jobs[i].reads & jobs[j].writes);
+            if (conflict && wave[j]+1 > wave[i]) wave[i] = wave[j]+1;
+        }
+        if (wave[i]+1 > waves) waves = wave[i]+1;
+    }
+
+    for (int w = 0; w < waves; w++) {
+        JobGroup group;
+        for (int i = 0; i < jobs.size(); i++) {
+            if (wave[i] == w) Submit(jobs[i].run, &group);
+        }
+        Wait(group);
+    }
+}
+
+/* The number of threads jobs run on, including the main thread */
+int JobSystem::ThreadCount() const { return queues.size(); }
+
+/*
+ * Whether the calling code is running as a job, including batches of `ParallelFor` run on the
+ * calling thread. Used to catch code that must only run on the main thread, outside of any job.
+ */
+bool JobSystem::InJob() { return in_job; }
+
+JobSystem::JobScope::JobScope() : outer(in_job) { in_job = true; }
+JobSystem::JobScope::~JobScope() { in_job = outer; }
+
+
+/* ==========  HELPER FUNCTIONS  ========== */
+
+/*
+ * Runs one job, from the thread's own queue if it has any, otherwise stolen from another thread.
+ *
+ * \returns `false` if there were no jobs to run.
+ */
+bool JobSystem::run_one(int thread)
+{
+    Job job;
+    bool found = false;
+    for (int i = 0; i < queues.size() && !found; i++) {
+        JobQueue& queue = *queues[(thread+i) % queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) continue;
+        // newest from our own queue, oldest from others
+        if (i == 0) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        found = true;
+    }
+    if (!found) return false;
+
+    queued--;
+    {
+        JobScope scope;
+        job.run();
+    }
+    if (job.group != nullptr) job.group->remaining--;
+    return true;
+}
+
+/* Runs jobs until the job system is destroyed, sleeping while there are none */
+void JobSystem::worker_loop(int thread)
+{
+    current_thread = thread;
+    while (running) {
+        if (run_one(thread)) continue;
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this]() { return queued.load() > 0 || !running; });
+    }
+}
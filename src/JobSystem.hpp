@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* Environment variable that sets the number of threads used for jobs, including the main thread */
+#define JOBS_ENV_VAR "BUNGUS_THREADS"
+
+/* Engine data that phase jobs declare they read or write. Jobs that don't conflict run together. */
+enum JobResource : unsigned int
+{
+    RESOURCE_TRANSFORMS = 1u << 0,
+    RESOURCE_VELOCITIES = 1u << 1,
+    RESOURCE_COLLIDERS  = 1u << 2,
+    RESOURCE_RENDERERS  = 1u << 3,
+    RESOURCE_SPRITES    = 1u << 4,
+    RESOURCE_PARTICLES  = 1u << 5,
+    /* The first bit free for games to use for their own data */
+    RESOURCE_USER       = 1u << 16,
+};
+
+/* A job in a phase, with the engine data it reads and writes */
+struct PhaseJob
+{
+    /* Name of the job, for debugging */
+    const char *name;
+    /* Bitmask of `JobResource`s the job reads */
+    unsigned int reads;
+    /* Bitmask of `JobResource`s the job writes */
+    unsigned int writes;
+    std::function<void()> run;
+};
+
+/* Counts the unfinished jobs submitted with it, so they can be waited for */
+struct JobGroup
+{
+    std::atomic<int> remaining{0};
+};
+
+/*
+ * Runs jobs on a pool of worker threads. Each thread has its own queue of jobs, and threads with
+ * nothing to do steal jobs from the other queues. A thread waiting for jobs to finish runs jobs
+ * itself, so jobs can start and wait for other jobs.
+ */
+class JobSystem
+{
+    public:
+
+        JobSystem(int threadCount = 0);
+        ~JobSystem();
+
+        void Submit(std::function<void()> job, JobGroup *group = nullptr);
+        void Wait(JobGroup& group);
+
+        template <typename F>
+        void ParallelFor(int count, int grain, F&& fn);
+
+        void RunPhase(const std::vector<PhaseJob>& jobs);
+
+        int ThreadCount() const;
+
+        static bool InJob();
+
+    private:
+
+        /* Marks the calling thread as running a job for as long as it exists */
+        struct JobScope
+        {
+            bool outer;
+            JobScope();
+            ~JobScope();
+        };
+
+        struct Job
+        {
+            std::function<void()> run;
+            JobGroup *group = nullptr;
+        };
+
+        /* A thread's job queue. The owner takes jobs from the back, and other threads steal from the front. */
+        struct JobQueue
+        {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        /* One queue per thread. Queue 0 belongs to the main thread. */
+        std::vector<std::unique_ptr<JobQueue>> queues;
+        std::vector<std::thread> workers;
+
+        /* Number of jobs waiting in all queues */
+        std::atomic<int> queued{0};
+        std::atomic<bool> running{true};
+        std::mutex sleep_mutex;
+        std::condition_variable wake;
+
+        bool run_one(int thread);
+        void worker_loop(int thread);
+};
+
+extern JobSystem jobSystem;
+
+
+/* ==========  TEMPLATE FUNCTIONS  ========== */
+
+/*
+ * Splits a range of indices into batches, and runs them in parallel. Returns once every batch is done.
+ *
+ * \param count The number of indices, from `0` to `count-1`.
+ * \param grain The fewest indices in a batch. Ranges no bigger than this run on the calling thread.
+ * \param fn Called as `fn(int begin, int end)` for each batch. Must be safe to run on several threads at once.
+ */
+template <typename F>
+void JobSystem::ParallelFor(int count, int grain, F&& fn)
+{
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+    if (count <= grain || workers.empty()) {
+        JobScope scope;
+        fn(0, count);
+        return;
+    }
+
+    // a few batches per thread, so threads that finish early can steal the rest
+    int batches = (count + grain-1) / grain;
+    if (batches > ThreadCount()*4) batches = ThreadCount()*4;
+    int size = (count + batches-1) / batches;
+
+    JobGroup group;
+    for (int begin = size; begin < count; begin += size) {
+        int end = (begin+size < count)? begin+size : count;
+        Submit([&fn, begin, end]() { fn(begin, end); }, &group);
+    }
+    // the calling thread takes the first batch
+    {
+        JobScope scope;
+        fn(0, size);
+    }
+    Wait(group);
+}
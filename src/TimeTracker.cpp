@@ -36,9 +36,18 @@ void TimeTracker::findDeltaTime()
     begin_time = t;
     // convert to seconds
     dt = delta / 1000.0f;
+    time += dt;
     // error handling for when 0ms passes between frames
     // frames per second is inverse of delta time, multiplied by 1000 (ms -> s)
     fps = (delta==0)? 1000 : 1.0/dt;
+
+    // run as many fixed updates as fit in the time passed, carrying the remainder to the next frame
+    fixed_accumulator += dt;
+    fixed_steps = (int)(fixed_accumulator / fixed_dt);
+    if (fixed_steps > MAX_FIXED_STEPS) {
+        fixed_steps = MAX_FIXED_STEPS;
+        fixed_accumulator = 0.0f;
+    } else fixed_accumulator -= fixed_steps * fixed_dt;
 }
 
 /* Assign the highest allowed framerate. Set to `-1` for uncapped framerate. */
@@ -47,10 +56,22 @@ void TimeTracker::setMaxFramerate(int maxFramerate)
     min_dt = 1000.0/maxFramerate;
 }
 
+/* Assign the time between fixed updates (in seconds). `1/60` by default. */
+void TimeTracker::setFixedDeltaTime(float seconds)
+{
+    if (seconds > 0.0f) fixed_dt = seconds;
+}
+
 /* The current number of frames per second. */
 int TimeTracker::Framerate() const { return fps; }
 /* The amount of TimeTracker elapsed since the last frame (in seconds) */
 float TimeTracker::deltaTime() const { return dt; }
+/* The time between fixed updates (in seconds). Use this in place of `deltaTime()` in `FixedUpdate`. */
+float TimeTracker::fixedDeltaTime() const { return fixed_dt; }
+/* The number of times `FixedUpdate` runs this frame. */
+int TimeTracker::FixedSteps() const { return fixed_steps; }
+/* The total amount of time passed in the game (in seconds). Advances once per frame, by `deltaTime()`. */
+double TimeTracker::Time() const { return time; }
 
 // initialise global object 
 TimeTracker gTime = TimeTracker();
\ No newline at end of file
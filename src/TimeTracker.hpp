@@ -2,6 +2,9 @@
 
 #include <ctime>
 
+/* The most fixed updates run in one frame. Time beyond this is dropped, so slow frames don't snowball. */
+#define MAX_FIXED_STEPS 8
+
 /* Tracks the amount of time passed between frames, and calculates framerate. */
 class TimeTracker
 {
@@ -12,9 +15,13 @@ class TimeTracker
 
         void findDeltaTime();
         void setMaxFramerate(int maxFramerate);
+        void setFixedDeltaTime(float seconds);
 
         int Framerate() const;
         float deltaTime() const;
+        float fixedDeltaTime() const;
+        int FixedSteps() const;
+        double Time() const;
 
     private:
 
@@ -26,6 +33,15 @@ class TimeTracker
         float dt = 0;
         /* The current number of frames per second. */
         int fps = 0;
+        /* The total amount of time passed in the game (in seconds). */
+        double time = 0.0;
+
+        /* The time between fixed updates (in seconds). */
+        float fixed_dt = 1.0f/60.0f;
+        /* Time passed that hasn't been covered by a fixed update yet (in seconds). */
+        float fixed_accumulator = 0.0f;
+        /* The number of fixed updates to run this frame. */
+        int fixed_steps = 0;
 };
 
 /* Global TimeTracker object */
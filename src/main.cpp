@@ -33,10 +33,12 @@ int main()
             // clear the window
             SDL_SetRenderDrawColor(gWindow->gRenderer, 0, 0, 0, 0xFF);
             SDL_RenderClear(gWindow->gRenderer);
+            gWindow->beginFrame();
 
             game.Update();
 
-            // update the window
+            // finish the frame's statistics and captures, then update the window
+            gWindow->endFrame();
             SDL_RenderPresent(gWindow->gRenderer);
         }
     }
@@ -25,16 +25,33 @@ void LAudio::free()
 
 bool LAudio::loadFromFile(std::string path)
 {
-    // get rid of preexisting audio
-    free();
-
     // load the audio from file
+    Mix_Chunk *newChunk = loadChunk(path);
+
+    // return success
+    return loadFromChunk(newChunk);
+}
+
+/* 
+ * Decodes audio from file, without storing it in an LAudio object.
+ * Safe to call from worker threads, once the audio device has been opened.
+ */
+Mix_Chunk* LAudio::loadChunk(std::string path)
+{
     Mix_Chunk *newChunk = Mix_LoadWAV(path.c_str());
 
     if (newChunk == NULL) 
     {
         printf("Unable to create audio from %s! SDL Error: %s\n", path.c_str(), Mix_GetError());
     }
+    return newChunk;
+}
+
+/* Stores already decoded audio. The LAudio object takes ownership of the chunk. */
+bool LAudio::loadFromChunk(Mix_Chunk *newChunk)
+{
+    // get rid of preexisting audio
+    free();
 
     // return success
     chunk = newChunk;
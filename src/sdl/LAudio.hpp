@@ -20,6 +20,12 @@ class LAudio
         // loads audio from an mp3 file
         bool loadFromFile(std::string path);
 
+        // stores already decoded audio, taking ownership of it
+        bool loadFromChunk(Mix_Chunk *newChunk);
+
+        // decodes audio from file without storing it
+        static Mix_Chunk* loadChunk(std::string path);
+
         // deallocates audio
         void free();
 
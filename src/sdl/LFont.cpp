@@ -1,4 +1,5 @@
 #include "LFont.hpp"
+#include "LTextCache.hpp"
 
 /*
  * Font management object.
@@ -25,7 +26,13 @@ LFont::~LFont()
 /* Deallocates the font, and clears member variables */
 void LFont::free(bool clearFilename)
 {
-    if (font!=NULL) TTF_CloseFont(font);
+    // glyphs belong to the font being freed
+    atlas = nullptr;
+    if (font!=NULL) {
+        // cached text rendered with this font can't be reused once it's closed
+        purgeTextCache(font);
+        TTF_CloseFont(font);
+    }
     font = NULL;
     size = -1;
     colour = {255,255,255,255};
@@ -98,6 +105,19 @@ void LFont::setColour(SDL_Color col) { colour = col; }
 
 /* A raw pointer to the TTF_Font */
 TTF_Font* LFont::get() const { return font; }
+
+/* 
+ * The glyph atlas caching this font's rasterised glyphs, created on first use. 
+ * The atlas is deleted whenever the font is freed or reloaded.
+ * 
+ * \param renderer The renderer the atlas will be drawn with.
+ * \returns `NULL` if no font is loaded.
+ */
+LGlyphAtlas* LFont::getAtlas(SDL_Renderer *renderer)
+{
+    if (atlas==nullptr && font!=NULL) atlas = std::make_unique<LGlyphAtlas>(renderer, font);
+    return atlas.get();
+}
 /* The point size */
 int LFont::getPtSize() const { return size; }
 /* Text colour */
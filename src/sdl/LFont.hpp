@@ -4,6 +4,9 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
+#include "LGlyphAtlas.hpp"
+
+#include <memory>
 #include <string>
 
 class LFont
@@ -13,6 +16,10 @@ class LFont
         LFont(int ptsize = 12, std::string filename = "", SDL_Color colour = {255,255,255,255});
         ~LFont();
 
+        // the font and atlas are owned by a single object, so fonts are shared by pointer instead
+        LFont(const LFont&) = delete;
+        LFont& operator=(const LFont&) = delete;
+
         void free(bool clearFilename = true);
 
         bool load(std::string newFilename, int ptsize = 12);
@@ -20,6 +27,7 @@ class LFont
         void setColour(SDL_Color col);
 
         TTF_Font* get() const;
+        LGlyphAtlas* getAtlas(SDL_Renderer *renderer);
         int getPtSize() const;
         SDL_Color getColour() const;
 
@@ -27,6 +35,8 @@ class LFont
 
         /* Raw pointer to the font object */
         TTF_Font *font = NULL;
+        /* Cache of the font's rasterised glyphs. Created when first requested. */
+        std::unique_ptr<LGlyphAtlas> atlas;
         /* The point size of the font */
         int size = -1;
 
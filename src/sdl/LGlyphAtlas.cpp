@@ -0,0 +1,181 @@
+#include "LGlyphAtlas.hpp"
+#include <stdio.h>
+
+/* Starting width and height of atlas textures */
+#define ATLAS_START_SIZE 256
+/* Largest width and height an atlas texture may grow to */
+#define ATLAS_MAX_SIZE 4096
+/* Space left between glyphs in the atlas, to avoid bleeding when filtered */
+#define ATLAS_PADDING 1
+
+// used to give each atlas a unique id
+static unsigned int atlas_count = 0;
+
+/*
+ * Texture containing every glyph of a font that has been drawn so far.
+ *
+ * \param renderer The renderer the atlas will be drawn with.
+ * \param font The font that glyphs are rasterised from.
+ */
+LGlyphAtlas::LGlyphAtlas(SDL_Renderer *renderer, TTF_Font *font)
+: renderer(renderer), font(font), id(++atlas_count)
+{
+    line_h = TTF_FontHeight(font);
+
+    // create blank atlas pixels and texture
+    pixels = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_START_SIZE, ATLAS_START_SIZE, 32, SDL_PIXELFORMAT_RGBA32);
+    if (pixels == NULL) {
+        printf("Failed to create glyph atlas! SDL Error: %s\n", SDL_GetError());
+        return;
+    }
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, pixels->w, pixels->h);
+    if (texture == NULL) {
+        printf("Failed to create glyph atlas texture! SDL Error: %s\n", SDL_GetError());
+        return;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    SDL_UpdateTexture(texture, NULL, pixels->pixels, pixels->pitch);
+}
+
+/* Deallocate resources */
+LGlyphAtlas::~LGlyphAtlas()
+{
+    free();
+}
+
+/* Deallocates the atlas texture and pixels, and forgets all glyphs */
+void LGlyphAtlas::free()
+{
+    if (texture != NULL) SDL_DestroyTexture(texture);
+    if (pixels != NULL) SDL_FreeSurface(pixels);
+    texture = NULL;
+    pixels = NULL;
+    glyphs.clear();
+    pen_x = pen_y = row_h = 0;
+}
+
+/*
+ * Finds a glyph in the atlas, rasterising and adding it first if it hasn't been used yet.
+ * 
+ * \param ch The character to find.
+ * \returns A pointer to the glyph, or `NULL` if the glyph could not be added.
+ */
+const LGlyph* LGlyphAtlas::getGlyph(Uint16 ch)
+{
+    // already rasterised
+    auto it = glyphs.find(ch);
+    if (it != glyphs.end()) return &it->second;
+    if (pixels == NULL) return NULL;
+
+    // rasterise the glyph in white, so it can be tinted any colour when drawn
+    SDL_Surface *surface = TTF_RenderGlyph_Solid(font, ch, {255,255,255,255});
+    if (surface == NULL) {
+        printf("Unable to render glyph! SDL_ttf Error: %s\n", TTF_GetError());
+        return NULL;
+    }
+
+    // move to the next row when the current one is full
+    if (pen_x + surface->w > pixels->w) {
+        pen_x = 0;
+        pen_y += row_h + ATLAS_PADDING;
+        row_h = 0;
+    }
+    // grow the atlas when there are no rows left
+    while (surface->w > pixels->w || pen_y + surface->h > pixels->h) {
+        if (!grow()) {
+            SDL_FreeSurface(surface);
+            return NULL;
+        }
+    }
+
+    // copy the glyph's pixels into the atlas
+    SDL_Rect dst = {pen_x, pen_y, surface->w, surface->h};
+    SDL_BlitSurface(surface, NULL, pixels, &dst);
+    SDL_FreeSurface(surface);
+    // only upload the region that changed
+    Uint8 *region = (Uint8*)pixels->pixels + (dst.y*pixels->pitch) + (dst.x*4);
+    SDL_UpdateTexture(texture, &dst, region, pixels->pitch);
+
+    // get horizontal metrics
+    int minx = 0, maxx = 0, miny = 0, maxy = 0, advance = 0;
+    TTF_GlyphMetrics(font, ch, &minx, &maxx, &miny, &maxy, &advance);
+
+    // advance packing position
+    pen_x += dst.w + ATLAS_PADDING;
+    row_h = (dst.h > row_h)? dst.h : row_h;
+
+    // glyphs overhanging to the left are rendered with their pixels starting at minx
+    LGlyph glyph = {dst, (minx<0)? minx : 0, advance};
+    return &glyphs.emplace(ch, glyph).first->second;
+}
+
+/* The kerning distance to add between two consecutive glyphs */
+int LGlyphAtlas::getKerning(Uint16 prev, Uint16 ch) const
+{
+    return TTF_GetFontKerningSizeGlyphs(font, prev, ch);
+}
+
+/*
+ * Doubles the size of the atlas, keeping all existing glyphs in place.
+ * 
+ * \returns `true` on success, `false` if the atlas is already at its largest size or creation fails.
+ */
+bool LGlyphAtlas::grow()
+{
+    int size = pixels->w * 2;
+    if (size > ATLAS_MAX_SIZE) {
+        printf("Glyph atlas is full!\n");
+        return false;
+    }
+
+    // copy the old pixels into the top left of a larger surface
+    SDL_Surface *newPixels = SDL_CreateRGBSurfaceWithFormat(0, size, size, 32, SDL_PIXELFORMAT_RGBA32);
+    SDL_Texture *newTexture = (newPixels==NULL)? NULL : 
+        SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, size, size);
+    if (newTexture == NULL) {
+        printf("Failed to grow glyph atlas! SDL Error: %s\n", SDL_GetError());
+        if (newPixels != NULL) SDL_FreeSurface(newPixels);
+        return false;
+    }
+    SDL_SetSurfaceBlendMode(pixels, SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(pixels, NULL, newPixels, NULL);
+    SDL_SetTextureBlendMode(newTexture, SDL_BLENDMODE_BLEND);
+    SDL_UpdateTexture(newTexture, NULL, newPixels->pixels, newPixels->pitch);
+
+    // swap in the new atlas
+    SDL_FreeSurface(pixels);
+    SDL_DestroyTexture(texture);
+    pixels = newPixels;
+    texture = newTexture;
+    return true;
+}
+
+/*
+ * Draws quads from the atlas texture in a single draw call.
+ * 
+ * \param vertices Four vertices per quad, in the order top left, top right, bottom left, bottom right.
+ * \param quadCount The number of quads to draw.
+ */
+void LGlyphAtlas::renderQuads(const SDL_Vertex *vertices, int quadCount)
+{
+    if (texture == NULL || quadCount <= 0) return;
+
+    // extend the shared index buffer when drawing more quads than ever before
+    for (int q = indices.size()/6; q < quadCount; q++) {
+        int v = q*4;
+        indices.insert(indices.end(), {v, v+1, v+2, v+2, v+1, v+3});
+    }
+
+    SDL_RenderGeometry(renderer, texture, vertices, quadCount*4, indices.data(), quadCount*6);
+}
+
+/* The atlas texture */
+SDL_Texture* LGlyphAtlas::getTexture() const { return texture; }
+/* Width of the atlas texture */
+int LGlyphAtlas::getWidth() const { return (pixels==NULL)? 0 : pixels->w; }
+/* Height of the atlas texture */
+int LGlyphAtlas::getHeight() const { return (pixels==NULL)? 0 : pixels->h; }
+/* Height of a line of text in the atlas' font */
+int LGlyphAtlas::getLineHeight() const { return line_h; }
+/* Identifies this atlas, unique between all atlases created */
+unsigned int LGlyphAtlas::getId() const { return id; }
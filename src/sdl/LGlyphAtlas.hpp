@@ -0,0 +1,76 @@
+#ifndef LGLYPHATLAS_HPP
+#define LGLYPHATLAS_HPP
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+
+#include <unordered_map>
+#include <vector>
+
+/* A rasterised glyph stored in a glyph atlas */
+struct LGlyph
+{
+    /* The region of the atlas holding the glyph's pixels */
+    SDL_Rect src;
+    /* Horizontal offset of the glyph's pixels from the pen position */
+    int offset;
+    /* Horizontal distance from this glyph's pen position to the next one's */
+    int advance;
+};
+
+/*
+ * Texture containing every glyph of a font that has been drawn so far.
+ * Glyphs are rasterised once, white, and tinted when drawn, so text can be 
+ * drawn as batched quads without creating any new textures.
+ */
+class LGlyphAtlas
+{
+    public:
+
+        LGlyphAtlas(SDL_Renderer *renderer, TTF_Font *font);
+        ~LGlyphAtlas();
+
+        void free();
+
+        const LGlyph* getGlyph(Uint16 ch);
+        int getKerning(Uint16 prev, Uint16 ch) const;
+
+        void renderQuads(const SDL_Vertex *vertices, int quadCount);
+
+        SDL_Texture* getTexture() const;
+        int getWidth() const;
+        int getHeight() const;
+        int getLineHeight() const;
+        unsigned int getId() const;
+
+    private:
+
+        /* The renderer the atlas texture belongs to */
+        SDL_Renderer *renderer = NULL;
+        /* The font glyphs are rasterised from */
+        TTF_Font *font = NULL;
+
+        /* The atlas texture that gets drawn from */
+        SDL_Texture *texture = NULL;
+        /* Copy of the atlas pixels, used when adding glyphs and growing the atlas */
+        SDL_Surface *pixels = NULL;
+
+        /* All glyphs added to the atlas so far */
+        std::unordered_map<Uint16,LGlyph> glyphs;
+
+        /* Position the next glyph will be placed at, and the height of the current row */
+        int pen_x = 0, pen_y = 0, row_h = 0;
+
+        /* Height of a line of text in the font */
+        int line_h = 0;
+
+        /* Identifies this atlas, unique between all atlases created */
+        unsigned int id;
+
+        /* Index buffer shared by all quads drawn with the atlas */
+        std::vector<int> indices;
+
+        bool grow();
+};
+
+#endif
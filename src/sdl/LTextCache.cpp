@@ -0,0 +1,139 @@
+#include "LTextCache.hpp"
+
+// whether the global cache currently exists. fonts may be freed during static destruction, after the cache is gone
+static bool global_alive = false;
+
+/*
+ * Least recently used cache of rendered text textures.
+ *
+ * \param budget The most texture memory the cache may hold, in bytes. 16MB by default.
+ */
+LTextCache::LTextCache(size_t budget)
+: budget(budget)
+{
+    if (this == &gTextCache) global_alive = true;
+}
+
+/* Deallocate resources */
+LTextCache::~LTextCache()
+{
+    clear();
+    if (this == &gTextCache) global_alive = false;
+}
+
+/*
+ * Finds the texture of a rendered string, rendering and caching it if it is not cached yet.
+ * Evicts the least recently used textures if the cache goes over its memory budget.
+ * 
+ * \param text The string to render. Should not contain newlines.
+ * \param colour The colour of the text.
+ * \param font The font to render with. If `NULL`, the window's global font is used.
+ * \param window The window the texture is rendered for.
+ * 
+ * \returns A pointer to the texture, or `nullptr` if rendering failed.
+ */
+std::shared_ptr<LTexture> LTextCache::get(std::string text, SDL_Color colour, TTF_Font *font, std::shared_ptr<LWindow> window)
+{
+    if (font == NULL) font = window->gFont->get();
+    Key key = {text, font, (Uint32)((colour.r<<24) | (colour.g<<16) | (colour.b<<8) | colour.a)};
+
+    // cached, move to front of the list as the most recently used
+    auto it = lookup.find(key);
+    if (it != lookup.end()) {
+        stats.hits++;
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->texture;
+    }
+
+    // not cached, render the text
+    stats.misses++;
+    auto texture = std::make_shared<LTexture>(window);
+    if (!texture->loadFromRenderedText(text, colour, font)) return nullptr;
+
+    // add to front of the list
+    size_t bytes = (size_t)texture->getWidth() * (size_t)texture->getHeight() * 4;
+    entries.push_front({key, texture, bytes});
+    lookup.emplace(key, entries.begin());
+    stats.bytes += bytes;
+    stats.entries++;
+
+    evict();
+    return texture;
+}
+
+/* Removes the least recently used textures until the cache is within budget. The most recent texture is always kept. */
+void LTextCache::evict()
+{
+    while (stats.bytes > budget && entries.size() > 1)
+    {
+        auto& entry = entries.back();
+        stats.bytes -= entry.bytes;
+        stats.entries--;
+        stats.evictions++;
+        lookup.erase(entry.key);
+        entries.pop_back();
+    }
+}
+
+/* Removes all textures rendered with a font. Call when the font is closed, so its textures can't be reused. */
+void LTextCache::purgeFont(TTF_Font *font)
+{
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->key.font == font) {
+            stats.bytes -= it->bytes;
+            stats.entries--;
+            lookup.erase(it->key);
+            it = entries.erase(it);
+        } else it++;
+    }
+}
+
+/* Removes all cached textures. */
+void LTextCache::clear()
+{
+    // empty the cache before the textures are freed, as freeing may purge fonts from the cache
+    std::list<Entry> old;
+    old.swap(entries);
+    lookup.clear();
+    stats.bytes = 0;
+    stats.entries = 0;
+}
+
+/* Set the most texture memory the cache may hold, in bytes. Evicts textures if the cache is now over budget. */
+void LTextCache::setBudget(size_t bytes)
+{
+    budget = bytes;
+    evict();
+}
+
+/* The most texture memory the cache may hold, in bytes. */
+size_t LTextCache::getBudget() const { return budget; }
+
+/* Hit, miss and eviction counts, and current memory use. */
+LTextCacheStats LTextCache::getStats() const { return stats; }
+
+/* Resets the hit, miss and eviction counts. */
+void LTextCache::resetStats()
+{
+    stats.hits = stats.misses = stats.evictions = 0;
+}
+
+bool LTextCache::Key::operator==(const Key& other) const {
+    return font==other.font && colour==other.colour && text==other.text;
+}
+
+size_t LTextCache::KeyHash::operator()(const Key& key) const {
+    size_t h = std::hash<std::string>()(key.text);
+    h ^= std::hash<void*>()(key.font) + 0x9e3779b9 + (h<<6) + (h>>2);
+    h ^= std::hash<Uint32>()(key.colour) + 0x9e3779b9 + (h<<6) + (h>>2);
+    return h;
+}
+
+// create global cache
+LTextCache gTextCache = LTextCache();
+
+/* Removes all textures rendered with a font from the global cache. Safe to call after the cache is destroyed. */
+void purgeTextCache(TTF_Font *font)
+{
+    if (global_alive) gTextCache.purgeFont(font);
+}
@@ -0,0 +1,84 @@
+#ifndef LTEXTCACHE_HPP
+#define LTEXTCACHE_HPP
+
+#include "LTexture.hpp"
+
+#include <list>
+#include <unordered_map>
+
+/* Usage statistics of a text cache */
+struct LTextCacheStats
+{
+    /* Number of lookups that found an existing texture */
+    unsigned long hits = 0;
+    /* Number of lookups that had to render a new texture */
+    unsigned long misses = 0;
+    /* Number of textures removed to stay within the memory budget */
+    unsigned long evictions = 0;
+    /* Estimated texture memory currently held by the cache, in bytes */
+    size_t bytes = 0;
+    /* Number of textures currently held by the cache */
+    size_t entries = 0;
+};
+
+/*
+ * Least recently used cache of rendered text textures, keyed by string, font and colour.
+ * Lets text drawn every frame reuse the same texture instead of rendering a new one.
+ */
+class LTextCache
+{
+    public:
+
+        LTextCache(size_t budget = 16*1024*1024);
+        ~LTextCache();
+
+        std::shared_ptr<LTexture> get(std::string text, SDL_Color colour, TTF_Font *font, std::shared_ptr<LWindow> window);
+
+        void purgeFont(TTF_Font *font);
+        void clear();
+
+        void setBudget(size_t bytes);
+        size_t getBudget() const;
+
+        LTextCacheStats getStats() const;
+        void resetStats();
+
+    private:
+
+        /* Identifies a rendered string */
+        struct Key
+        {
+            std::string text;
+            TTF_Font *font;
+            Uint32 colour;
+            bool operator==(const Key& other) const;
+        };
+        struct KeyHash { size_t operator()(const Key& key) const; };
+
+        /* A cached texture */
+        struct Entry
+        {
+            Key key;
+            std::shared_ptr<LTexture> texture;
+            size_t bytes;
+        };
+
+        /* All cached textures, most recently used first */
+        std::list<Entry> entries;
+        /* Finds entries by key */
+        std::unordered_map<Key,std::list<Entry>::iterator,KeyHash> lookup;
+
+        /* The most texture memory the cache may hold, in bytes */
+        size_t budget;
+
+        LTextCacheStats stats;
+
+        void evict();
+};
+
+/* Global cache used by `renderText` */
+extern LTextCache gTextCache;
+
+void purgeTextCache(TTF_Font *font);
+
+#endif
@@ -4,8 +4,11 @@
 #include <sstream>
 #include <stdio.h>
 #include <string>
+#include <cstring>
+#include <algorithm>
 
 #include "LTexture.hpp"
+#include "LTextCache.hpp"
 
 LTexture::LTexture(std::shared_ptr<LWindow> gHolder) : gHolder(gHolder)
 {
@@ -87,7 +90,8 @@ bool LTexture::solidColour(SDL_Color colour, int width, int height)
   if (mTexture == NULL) {
     printf("Failed to create solid colour! SDL_Error: %s", SDL_GetError());
   } else {
-    // prepare texture and renderer
+    // prepare texture and renderer, remembering what was being rendered to
+    SDL_Texture *prevTarget = SDL_GetRenderTarget(gHolder->gRenderer);
     SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
     SDL_SetRenderTarget(gHolder->gRenderer, mTexture);
     SDL_SetRenderDrawBlendMode(gHolder->gRenderer, SDL_BLENDMODE_NONE);
@@ -95,7 +99,9 @@ bool LTexture::solidColour(SDL_Color colour, int width, int height)
     // fill texture with colour
     SDL_RenderFillRect(gHolder->gRenderer, NULL);
     // reset renderer for rendering 
-    SDL_SetRenderTarget(gHolder->gRenderer, NULL);
+    SDL_SetRenderTarget(gHolder->gRenderer, prevTarget);
+    gHolder->countTargetSwitch();
+    gHolder->countTargetSwitch();
     SDL_SetRenderDrawBlendMode(gHolder->gRenderer, SDL_BLENDMODE_BLEND);
     // set width and height members
     mWidth = width;
@@ -105,15 +111,152 @@ bool LTexture::solidColour(SDL_Color colour, int width, int height)
   return mTexture != NULL;
 }
 
-bool LTexture::loadFromFile(std::string path)
+/*
+ * Creates a texture whose pixels can be changed every frame. A copy of the pixels is 
+ * kept in memory, and only the region changed since the last upload is copied to the
+ * texture, so updates never create a new texture.
+ *
+ * \note created texture will have pixel format `SDL_PIXELFORMAT_RGBA32`
+ * and texture access `SDL_TEXTUREACCESS_STREAMING`
+ * 
+ * \param width, height the dimensions of the created texture
+ * \param colour the RGBA colour every pixel starts as
+ * 
+ * \return `true` for successful texture creation.
+ * \return `false` for failure.
+ */
+bool LTexture::createStreaming(int width, int height, SDL_Color colour)
 {
-  // Get rid of preexisting texture
+  // free pre-existing texture
   free();
+  // create empty texture
+  mTexture = SDL_CreateTexture(gHolder->gRenderer,
+              SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING,
+              width, height);
+  // error handling
+  if (mTexture == NULL) {
+    printf("Failed to create streaming texture! SDL_Error: %s\n", SDL_GetError());
+    return false;
+  }
+  SDL_SetTextureBlendMode(mTexture, SDL_BLENDMODE_BLEND);
+  mWidth = width;
+  mHeight = height;
+
+  // fill the pixel buffer, and upload all of it
+  mPixels.assign(width*height, packColour(colour));
+  markDirty({0, 0, width, height});
+  uploadPixels();
+  return true;
+}
+
+/*
+ * Gives direct access to a streaming texture's pixel buffer. Rows are `getWidth()` pixels apart.
+ * The buffer keeps its contents between locks, so only changed pixels need writing.
+ * 
+ * \param region the region that will be changed. The whole texture if `NULL`.
+ * 
+ * \return the start of the pixel buffer, or `NULL` if the texture isn't streaming.
+ */
+Uint32 *LTexture::lockPixels(const SDL_Rect *region)
+{
+  if (mPixels.empty()) return NULL;
+  markDirty((region == NULL)? SDL_Rect{0, 0, mWidth, mHeight} : *region);
+  return mPixels.data();
+}
+
+// uploads the pixels changed since the texture was locked
+void LTexture::unlockPixels() { uploadPixels(); }
 
-  // The final texture
-  SDL_Texture *newTexture = NULL;
+// sets a single pixel of a streaming texture. uploaded by the next unlockPixels or uploadPixels
+void LTexture::setPixel(int x, int y, SDL_Color colour)
+{
+  if (mPixels.empty() || x < 0 || y < 0 || x >= mWidth || y >= mHeight) return;
+  mPixels[y*mWidth + x] = packColour(colour);
+  markDirty({x, y, 1, 1});
+}
+
+// gets a single pixel of a streaming texture. transparent black if out of bounds
+SDL_Color LTexture::getPixel(int x, int y)
+{
+  SDL_Color colour = {0, 0, 0, 0};
+  if (mPixels.empty() || x < 0 || y < 0 || x >= mWidth || y >= mHeight) return colour;
+  memcpy(&colour, &mPixels[y*mWidth + x], sizeof(Uint32));
+  return colour;
+}
+
+// copies only the changed region of the pixel buffer to the texture, one row at a time
+void LTexture::uploadPixels()
+{
+  if (mTexture == NULL || mPixels.empty() || mDirty.w <= 0 || mDirty.h <= 0) return;
+
+  void *dst;
+  int pitch;
+  if (SDL_LockTexture(mTexture, &mDirty, &dst, &pitch) < 0) {
+    printf("Unable to lock streaming texture! SDL Error: %s\n", SDL_GetError());
+    return;
+  }
+  const Uint32 *src = mPixels.data() + mDirty.y*mWidth + mDirty.x;
+  for (int row = 0; row < mDirty.h; row++) {
+    memcpy((Uint8*)dst + row*pitch, src + row*mWidth, mDirty.w*sizeof(Uint32));
+  }
+  SDL_UnlockTexture(mTexture);
 
+  mDirty = {0, 0, 0, 0};
+  mVersion++;
+}
+
+// whether the texture was made by createStreaming
+bool LTexture::isStreaming() { return !mPixels.empty(); }
+
+// packs a colour into a pixel value for a streaming texture. RGBA32 stores bytes in r, g, b, a order
+Uint32 LTexture::packColour(SDL_Color colour)
+{
+  Uint32 pixel;
+  memcpy(&pixel, &colour, sizeof(Uint32));
+  return pixel;
+}
+
+// grows the region waiting to be uploaded to include another region, clipped to the texture
+void LTexture::markDirty(SDL_Rect region)
+{
+  int x0 = std::max(region.x, 0), y0 = std::max(region.y, 0),
+      x1 = std::min(region.x + region.w, mWidth), y1 = std::min(region.y + region.h, mHeight);
+  if (x1 <= x0 || y1 <= y0) return;
+
+  if (mDirty.w > 0 && mDirty.h > 0) {
+    x0 = std::min(x0, mDirty.x); y0 = std::min(y0, mDirty.y);
+    x1 = std::max(x1, mDirty.x + mDirty.w); y1 = std::max(y1, mDirty.y + mDirty.h);
+  }
+  mDirty = {x0, y0, x1 - x0, y1 - y0};
+}
+
+bool LTexture::loadFromFile(std::string path)
+{
   // Load image at specified path
+  SDL_Surface *loadedSurface = loadSurface(path);
+  if (loadedSurface == NULL)
+  {
+    free();
+    return false;
+  }
+
+  // Create texture from surface pixels
+  bool success = loadFromSurface(loadedSurface);
+  if (!success)
+  {
+    printf("Unable to create texture from %s! SDL Error: %s\n", path.c_str(),
+           SDL_GetError());
+  }
+
+  // Get rid of old loaded surface
+  SDL_FreeSurface(loadedSurface);
+  return success;
+}
+
+// Decodes an image file and colour keys it, without creating a texture.
+// Only uses the CPU, so is safe to call from worker threads
+SDL_Surface *LTexture::loadSurface(std::string path)
+{
   SDL_Surface *loadedSurface = IMG_Load(path.c_str());
   if (loadedSurface == NULL)
   {
@@ -125,28 +268,25 @@ bool LTexture::loadFromFile(std::string path)
     // Color key image
     SDL_SetColorKey(loadedSurface, SDL_TRUE,
                     SDL_MapRGB(loadedSurface->format, 0, 0xFF, 0xFF));
+  }
+  return loadedSurface;
+}
 
-    // Create texture from surface pixels
-    newTexture =
-        SDL_CreateTextureFromSurface(gHolder->gRenderer, loadedSurface);
-    if (newTexture == NULL)
-    {
-      printf("Unable to create texture from %s! SDL Error: %s\n", path.c_str(),
-             SDL_GetError());
-    }
-    else
-    {
-      // Get image dimensions
-      mWidth = loadedSurface->w;
-      mHeight = loadedSurface->h;
-    }
+bool LTexture::loadFromSurface(SDL_Surface *surface)
+{
+  // Get rid of preexisting texture
+  free();
 
-    // Get rid of old loaded surface
-    SDL_FreeSurface(loadedSurface);
+  // Create texture from surface pixels
+  mTexture = SDL_CreateTextureFromSurface(gHolder->gRenderer, surface);
+  if (mTexture != NULL)
+  {
+    // Get image dimensions
+    mWidth = surface->w;
+    mHeight = surface->h;
   }
 
   // Return success
-  mTexture = newTexture;
   return mTexture != NULL;
 }
 
@@ -160,24 +300,32 @@ void LTexture::free()
     mWidth = 0;
     mHeight = 0;
   }
+  // release the streaming pixel buffer
+  std::vector<Uint32>().swap(mPixels);
+  mDirty = {0, 0, 0, 0};
+  // every way of loading a texture frees the old one first
+  mVersion++;
 }
 
 void LTexture::setColor(Uint8 red, Uint8 green, Uint8 blue)
 {
   // Modulate texture rgb
   SDL_SetTextureColorMod(mTexture, red, green, blue);
+  mVersion++;
 }
 
-void LTexture::setBlendMode(SDL_BlendMode blending)
+bool LTexture::setBlendMode(SDL_BlendMode blending)
 {
   // Set blending function
-  SDL_SetTextureBlendMode(mTexture, blending);
+  mVersion++;
+  return SDL_SetTextureBlendMode(mTexture, blending) == 0;
 }
 
 void LTexture::setAlpha(Uint8 alpha)
 {
   // Modulate texture alpha
   SDL_SetTextureAlphaMod(mTexture, alpha);
+  mVersion++;
 }
 
 void LTexture::renderAsBackground(SDL_Rect *clip, double angle,
@@ -189,6 +337,7 @@ void LTexture::renderAsBackground(SDL_Rect *clip, double angle,
   // Render to screen
   SDL_RenderCopyEx(gHolder->gRenderer, mTexture, clip, &renderQuad, angle,
                    center, flip);
+  gHolder->countDraw(mTexture);
 }
 
 void LTexture::render(int x, int y, SDL_Rect *dest, SDL_Rect *clip, double angle,
@@ -207,6 +356,7 @@ void LTexture::render(int x, int y, SDL_Rect *dest, SDL_Rect *clip, double angle
   // Render to screen
   SDL_RenderCopyEx(gHolder->gRenderer, mTexture, clip, &renderQuad, angle,
                    center, flip);
+  gHolder->countDraw(mTexture);
 }
 
 void LTexture::render(SDL_Rect *dest, SDL_Rect *clip, double angle,
@@ -215,6 +365,27 @@ void LTexture::render(SDL_Rect *dest, SDL_Rect *clip, double angle,
   // Render to screen
   SDL_RenderCopyEx(gHolder->gRenderer, mTexture, clip, dest, angle,
                    center, flip);
+  gHolder->countDraw(mTexture);
+}
+
+void LTexture::renderF(const SDL_FRect *dest, const SDL_Rect *clip, SDL_RendererFlip flip, SDL_Color tint)
+{
+  // textures are shared, so only modulate for this draw, keeping the texture's own modulation
+  bool tinted = tint.r!=255 || tint.g!=255 || tint.b!=255 || tint.a!=255;
+  Uint8 r, g, b, a;
+  if (tinted) {
+    SDL_GetTextureColorMod(mTexture, &r, &g, &b);
+    SDL_GetTextureAlphaMod(mTexture, &a);
+    SDL_SetTextureColorMod(mTexture, r*tint.r/255, g*tint.g/255, b*tint.b/255);
+    SDL_SetTextureAlphaMod(mTexture, a*tint.a/255);
+  }
+  // Render to screen, without rounding the destination to whole pixels
+  SDL_RenderCopyExF(gHolder->gRenderer, mTexture, clip, dest, 0.0, NULL, flip);
+  gHolder->countDraw(mTexture);
+  if (tinted) {
+    SDL_SetTextureColorMod(mTexture, r, g, b);
+    SDL_SetTextureAlphaMod(mTexture, a);
+  }
 }
 
 // renders to another texture
@@ -226,12 +397,14 @@ void LTexture::render_toTexture(LTexture *target, int x, int y, SDL_Rect *dest,
     printf("Failed to render to texture! SDL Error: %s\n", SDL_GetError());
     return;
   }
+  gHolder->countTargetSwitch();
   render(x, y, dest, clip, angle, center, flip);
 
   // reset the render target
   if (SDL_SetRenderTarget(gHolder->gRenderer, NULL) < 0) {
     printf("Failed to reset render target! SDL Error: %s\n", SDL_GetError());
   }
+  gHolder->countTargetSwitch();
 }
 // renders to another texture
 void LTexture::render_toTexture(LTexture *target, SDL_Rect *dest, SDL_Rect *clip, double angle,
@@ -242,18 +415,56 @@ void LTexture::render_toTexture(LTexture *target, SDL_Rect *dest, SDL_Rect *clip
     printf("Failed to render to texture! SDL Error: %s\n", SDL_GetError());
     return;
   }
+  gHolder->countTargetSwitch();
   render(dest, clip, angle, center, flip);
 
   // reset the render target
   if (SDL_SetRenderTarget(gHolder->gRenderer, NULL) < 0) {
     printf("Failed to reset render target! SDL Error: %s\n", SDL_GetError());
   }
+  gHolder->countTargetSwitch();
+}
+
+// makes all following rendering draw onto this texture, until resetRenderTarget is called.
+// lets many things be drawn onto the texture with a single render target switch
+bool LTexture::setAsRenderTarget()
+{
+  mPrevTarget = SDL_GetRenderTarget(gHolder->gRenderer);
+  if (SDL_SetRenderTarget(gHolder->gRenderer, mTexture) < 0) {
+    printf("Failed to render to texture! SDL Error: %s\n", SDL_GetError());
+    return false;
+  }
+  gHolder->countTargetSwitch();
+  return true;
+}
+
+// restores the render target that was active before setAsRenderTarget
+void LTexture::resetRenderTarget()
+{
+  if (SDL_SetRenderTarget(gHolder->gRenderer, mPrevTarget) < 0) {
+    printf("Failed to reset render target! SDL Error: %s\n", SDL_GetError());
+  }
+  gHolder->countTargetSwitch();
+  mPrevTarget = NULL;
+}
+
+// Renders indexed triangles textured with this texture, in a single draw call.
+// positions, colours and uv coordinates are read from seperate tightly packed arrays
+void LTexture::renderGeometry(const float *xy, const SDL_Color *colours, const float *uv, int numVertices,
+                              const int *indices, int numIndices)
+{
+  if (mTexture == NULL || numVertices <= 0) return;
+  SDL_RenderGeometryRaw(gHolder->gRenderer, mTexture, xy, sizeof(float)*2, colours, sizeof(SDL_Color),
+                        uv, sizeof(float)*2, numVertices, indices, numIndices, sizeof(int));
+  gHolder->countDraw(mTexture, numVertices);
 }
 
 int LTexture::getWidth() { return mWidth; }
 
 int LTexture::getHeight() { return mHeight; }
 
+unsigned int LTexture::getVersion() { return mVersion; }
+
 
 void renderText( std::string txt, int x, int y, std::shared_ptr<LWindow> window, SDL_Color colour, TTF_Font *font, TextOrientation orientation )
 {
@@ -275,13 +486,14 @@ void renderText( std::string txt, int x, int y, std::shared_ptr<LWindow> window,
   for (i = 0; i < n; i++) 
   {
     if (strings[i].size() == 0) continue;
-    auto rend = std::make_unique<LTexture>(window);
-    if (!rend->loadFromRenderedText(strings[i], colour, font)) {
+    // reuse the texture if this line has been rendered recently
+    auto rend = gTextCache.get(strings[i], colour, font, window);
+    if (rend == nullptr) {
       std::cerr << "failed to load rendered text!";
+      continue;
     }
     int X = (orientation == Centred)? x - (rend->getWidth()/2) : x;
     rend->render(X, y);
     y += rend->getHeight()+3;
-    rend->free();
   }
 }
\ No newline at end of file
@@ -32,6 +32,12 @@ public:
   // Loads image at specified path
   bool loadFromFile(std::string path);
 
+  // Creates texture from a surface's pixels. Does not free the surface
+  bool loadFromSurface(SDL_Surface *surface);
+
+  // Decodes image at specified path into a surface, without creating a texture
+  static SDL_Surface *loadSurface(std::string path);
+
 #if defined(SDL_TTF_MAJOR_VERSION)
   // Creates image from font string
   bool loadFromRenderedText(std::string textureText, SDL_Color textColor = {255,255,255,255}, TTF_Font *font = NULL);
@@ -40,14 +46,37 @@ public:
   // makes a texture of a solid colour
   bool solidColour(SDL_Color colour, int width = 1, int height = 1);
 
+  // makes a blank texture whose pixels can be changed every frame, without creating a new texture.
+  // pixels are 32 bit, in SDL_PIXELFORMAT_RGBA32 byte order
+  bool createStreaming(int width, int height, SDL_Color colour = {0,0,0,0});
+
+  // gives access to a streaming texture's pixels, marking a region (the whole texture if NULL) as changed.
+  // changes are uploaded by unlockPixels. rows are getWidth() pixels apart
+  Uint32 *lockPixels(const SDL_Rect *region = NULL);
+  // uploads the pixels changed since the texture was locked
+  void unlockPixels();
+
+  // sets a single pixel of a streaming texture. uploaded by the next unlockPixels or uploadPixels
+  void setPixel(int x, int y, SDL_Color colour);
+  // gets a single pixel of a streaming texture
+  SDL_Color getPixel(int x, int y);
+  // copies only the changed region of the pixel buffer to the texture
+  void uploadPixels();
+
+  // whether the texture was made by createStreaming
+  bool isStreaming();
+
+  // packs a colour into a pixel value for a streaming texture
+  static Uint32 packColour(SDL_Color colour);
+
   // Deallocates texture
   void free();
 
   // Set color modulation
   void setColor(Uint8 red, Uint8 green, Uint8 blue);
 
-  // Set blending
-  void setBlendMode(SDL_BlendMode blending);
+  // Set blending. returns false if the renderer doesn't support the blend mode
+  bool setBlendMode(SDL_BlendMode blending);
 
   // Set alpha modulation
   void setAlpha(Uint8 alpha);
@@ -69,20 +98,50 @@ public:
   // renders to another texture
   void render_toTexture(LTexture *target, SDL_Rect *dest, SDL_Rect *clip = NULL, double angle = 0.0,
               SDL_Point *center = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE);
+
+  // makes all following rendering draw onto this texture, until resetRenderTarget is called
+  bool setAsRenderTarget();
+  // restores the render target that was active before setAsRenderTarget
+  void resetRenderTarget();
+
+  // Renders texture to a rect with sub-pixel position and size, modulated by a tint for this draw only
+  void renderF(const SDL_FRect *dest, const SDL_Rect *clip = NULL, SDL_RendererFlip flip = SDL_FLIP_NONE,
+               SDL_Color tint = {255,255,255,255});
+
+  // Renders indexed triangles textured with this texture, in a single draw call.
+  // uv coordinates are normalised, from 0 to 1 across the texture
+  void renderGeometry(const float *xy, const SDL_Color *colours, const float *uv, int numVertices,
+                      const int *indices, int numIndices);
               
   // Gets image dimensions
   int getWidth();
   int getHeight();
 
+  // changes whenever the texture's pixels, colour or alpha modulation, or blending change
+  unsigned int getVersion();
+
 private:
   // The actual hardware texture
   SDL_Texture *mTexture;
 
   std::shared_ptr<LWindow> gHolder;
 
+  // The render target to restore after rendering onto this texture
+  SDL_Texture *mPrevTarget = NULL;
+
   // Image dimensions
   int mWidth;
   int mHeight;
+
+  // Copy of a streaming texture's pixels, kept between updates
+  std::vector<Uint32> mPixels;
+  // Region of mPixels changed since the last upload
+  SDL_Rect mDirty = {0, 0, 0, 0};
+
+  // Incremented whenever what the texture looks like changes
+  unsigned int mVersion = 0;
+
+  void markDirty(SDL_Rect region);
 };
 
 
@@ -20,6 +20,14 @@ LWindow::LWindow(int width, int height, std::string name)
   wHeight = height;
   windowName = name;
 
+  // run without a display, for automated tests on machines without a GPU
+  const char *env = getenv(HEADLESS_ENV_VAR);
+  headless = env != NULL && std::string(env) != "0";
+  if (headless) {
+    SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    SDL_SetHint(SDL_HINT_AUDIODRIVER, "dummy");
+  }
+
   // Initialize SDL
   if (SDL_Init(SDL_INIT_VIDEO|SDL_INIT_AUDIO) < 0)
   {
@@ -43,7 +51,7 @@ LWindow::LWindow(int width, int height, std::string name)
   // Create window
   gWindow = SDL_CreateWindow(windowName.c_str(), SDL_WINDOWPOS_UNDEFINED,
                              SDL_WINDOWPOS_UNDEFINED, wWidth, wHeight,
-                             SDL_WINDOW_SHOWN);
+                             (headless)? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN);
   if (gWindow == NULL)
   {
     printf("Window could not be created! SDL Error: %s\n", SDL_GetError());
@@ -56,7 +64,9 @@ LWindow::LWindow(int width, int height, std::string name)
   }
 
   // Create renderer for window
-  gRenderer = SDL_CreateRenderer(gWindow, -1, SDL_RENDERER_ACCELERATED);
+  // the software renderer draws identically on every machine, so frames can be compared
+  Uint32 rendererFlags = (headless)? SDL_RENDERER_SOFTWARE|SDL_RENDERER_TARGETTEXTURE : SDL_RENDERER_ACCELERATED;
+  gRenderer = SDL_CreateRenderer(gWindow, -1, rendererFlags);
   if (gRenderer == NULL)
   {
     printf("Renderer could not be created! SDL Error: %s\n", SDL_GetError());
@@ -242,4 +252,63 @@ LWindow::~LWindow()
   IMG_Quit();
   SDL_Quit();
   Mix_Quit();
-}
\ No newline at end of file
+}
+
+bool LWindow::isHeadless() { return headless; }
+
+void LWindow::beginFrame()
+{
+  frameStats = LRenderStats();
+  lastTexture = NULL;
+}
+
+void LWindow::endFrame()
+{
+  lastStats = frameStats;
+  // save any requested captures, now that everything has been drawn
+  for (auto& path : captures) saveFrame(path);
+  captures.clear();
+}
+
+void LWindow::captureFrame(std::string path) { captures.push_back(path); }
+
+bool LWindow::saveFrame(std::string path)
+{
+  int w, h;
+  if (SDL_GetRendererOutputSize(gRenderer, &w, &h) < 0) {
+    printf("Unable to get renderer size! SDL Error: %s\n", SDL_GetError());
+    return false;
+  }
+
+  // read the renderer's pixels into a surface, and write it out
+  SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_RGBA32);
+  if (surface == NULL) {
+    printf("Unable to create frame surface! SDL Error: %s\n", SDL_GetError());
+    return false;
+  }
+  bool success = SDL_RenderReadPixels(gRenderer, NULL, SDL_PIXELFORMAT_RGBA32, surface->pixels, surface->pitch) == 0;
+  if (!success) printf("Unable to read frame pixels! SDL Error: %s\n", SDL_GetError());
+  else if (IMG_SavePNG(surface, path.c_str()) != 0) {
+    printf("Unable to save frame to %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+    success = false;
+  }
+
+  SDL_FreeSurface(surface);
+  return success;
+}
+
+LRenderStats LWindow::getRenderStats() { return lastStats; }
+
+void LWindow::countDraw(SDL_Texture *texture, int vertices)
+{
+  frameStats.drawCalls++;
+  frameStats.vertices += vertices;
+  if (texture != lastTexture) {
+    frameStats.textureSwitches++;
+    lastTexture = texture;
+  }
+}
+
+void LWindow::countCulled(int count) { frameStats.culled += count; }
+
+void LWindow::countTargetSwitch() { frameStats.targetSwitches++; }
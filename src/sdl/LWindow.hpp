@@ -8,9 +8,28 @@
 #include <stdio.h>
 #include <string>
 #include <memory>
+#include <vector>
 
 #include "LFont.hpp"
 
+/* Environment variable that runs the window headless when set to anything but "0" */
+#define HEADLESS_ENV_VAR "BUNGUS_HEADLESS"
+
+/* Counts of rendering work done during a frame */
+struct LRenderStats
+{
+  /* Number of copy and geometry calls submitted to the renderer */
+  int drawCalls = 0;
+  /* Number of vertices submitted, counting 4 for each copied rect */
+  int vertices = 0;
+  /* Number of things skipped for being outside of a camera's view */
+  int culled = 0;
+  /* Number of draw calls using a different texture to the draw call before */
+  int textureSwitches = 0;
+  /* Number of times the render target was changed */
+  int targetSwitches = 0;
+};
+
 /* SDL Init object */
 class LWindow
 {
@@ -56,6 +75,27 @@ public:
   /* Changes window name */
   void setName(std::string newName);
 
+  /* Whether the window was created without a display, using the dummy video driver and software renderer */
+  bool isHeadless();
+
+  /* Starts counting render statistics for a new frame. Called before anything is rendered */
+  void beginFrame();
+  /* Finishes the frame's render statistics, and saves the frame if requested. Called before presenting */
+  void endFrame();
+
+  /* Requests the current frame be saved as a PNG when it is finished */
+  void captureFrame(std::string path);
+  /* Saves what has been rendered so far this frame as a PNG */
+  bool saveFrame(std::string path);
+
+  /* Render statistics of the last finished frame */
+  LRenderStats getRenderStats();
+
+  /* Render statistic counters, called by anything that draws */
+  void countDraw(SDL_Texture *texture, int vertices = 4);
+  void countCulled(int count = 1);
+  void countTargetSwitch();
+
 private:
   /* The window being rendered to */
   SDL_Window *gWindow = NULL;
@@ -77,6 +117,16 @@ private:
 
   /* The name of the window */
   std::string windowName= "";
+
+  /* Running without a display */
+  bool headless = false;
+
+  /* Statistics of the frame being rendered, and of the last finished frame */
+  LRenderStats frameStats, lastStats;
+  /* The texture used by the most recent draw call */
+  SDL_Texture *lastTexture = NULL;
+  /* Paths to save the current frame to once it is finished */
+  std::vector<std::string> captures;
 };
 
 #endif
\ No newline at end of file